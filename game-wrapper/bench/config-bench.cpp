@@ -0,0 +1,399 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+#include "../src/configs.h"
+#include "../src/binary-log.h"
+#include "../src/patient-db.h"
+#include "../src/config-registry.h"
+
+#include <scgms/rtl/rattime.h>
+#include <scgms/utils/string_utils.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Micro-benchmark of config building; compares the compiled-template builder with the original char-by-char builder
+ * Outputs of both builders are checked to be equal for every built-in template, purpose and kind of logs first; the benchmark fails if they differ
+ * Usage: game-wrapper-config-bench [iterations]
+ */
+
+/*
+ * The original builder, kept as a reference; copied from configs.cpp as it was before templates got compiled
+ * The only change is marked below: discarding rules of the headless purpose and of binary and preloaded logs, which were added to the compiled
+ * builder along with these features, so that both builders may be compared on all purposes and kinds of logs
+ */
+namespace baseline
+{
+	const char* rsPatient_Params_Placeholder = "{{PatientParameters}}";
+	const char* rsPatient_Model_Stepping_Placeholder = "{{PatientStepping}}";
+	const char* rsLog_File_Source_Placeholder = "{{LogFileSource}}";
+	const char* rsLog_File_Target_Placeholder = "{{LogFileTarget}}";
+	const char* rsFilter_Pos_Placeholder = "{{FilterIdx}}";
+
+	const char* rsMeta_Filter_Marker = ";META:";
+	const char  rsMeta_Delimiter = ',';
+	const char  rsMeta_Value_Delimiter = ':';
+	const char* rsMeta_Gameplay = "GAMEPLAY";
+	const char* rsMeta_Optimalization = "OPTIMALIZATION";
+	const char* rsMeta_Headless = "HEADLESS";
+	const char* rsMeta_All_Modes = "ALL";
+	const char* rsMeta_Opt_Filter = "OPTFILTER";
+	const char* rsMeta_Log_Source = "LOGSOURCE";
+	const char* rsMeta_Log_Sink = "LOGSINK";
+
+	const char* rsFilter_Tag_Start = "[Filter_";
+
+	bool Match_Replace_And_Advance(const char** itr, std::ostringstream& oss, const char* needle, const std::string& replaceWith)
+	{
+		if (strncmp(*itr, needle, strlen(needle)) == 0)
+		{
+			oss << replaceWith;
+			*itr += strlen(needle);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	bool Match_And_Advance(const char** itr, const char* needle)
+	{
+		if (strncmp(*itr, needle, strlen(needle)) == 0)
+		{
+			*itr += strlen(needle);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	bool Match(const char** itr, const char* needle)
+	{
+		return (strncmp(*itr, needle, strlen(needle)) == 0);
+	}
+
+	inline void Discard_Rest_Of_Line(const char** itr)
+	{
+		// read until the end of line (or end of input)
+		while (**itr != '\0' && **itr != '\r' && **itr != '\n')
+			(*itr)++;
+
+		// read while there are just new lines
+		while (**itr == '\r' || **itr == '\n')
+			(*itr)++;
+	}
+
+	std::string Read_Rest_Of_Line(const char** itr)
+	{
+		const char* begin = *itr;
+		// read until the end of line (or end of input)
+		while (**itr != '\0' && **itr != '\r' && **itr != '\n')
+			(*itr)++;
+
+		const char* end = *itr;
+
+		// read while there are just new lines
+		while (**itr == '\r' || **itr == '\n')
+			(*itr)++;
+
+		return std::string{ begin, end };
+	}
+
+	std::map<std::string, std::string> Parse_Meta_String(const std::string& str)
+	{
+		std::map<std::string, std::string> res;
+
+		std::istringstream iss(str);
+		std::string line;
+		while (std::getline(iss, line, rsMeta_Delimiter))
+		{
+			auto delimpos = line.find(rsMeta_Value_Delimiter);
+			if (delimpos == std::string::npos)
+				res[line] = "";
+			else
+				res[line.substr(0, delimpos)] = line.substr(delimpos + 1);
+		}
+
+		return res;
+	}
+
+	static inline void Build_Filter_Idx_Str(size_t idx, std::string& target)
+	{
+		std::ostringstream oss;
+		oss << std::setw(3) << std::setfill('0') << idx;
+
+		target = oss.str();
+	}
+
+	enum class NDiscard_State
+	{
+		No_Discard,
+		Follow_Up,
+		Discard,
+	};
+
+	static std::string Build_Config_From_Template(const char* citr, const std::string& patientParams, const double stepping, const std::string& logFilenameIn, const std::string& logFilenameOut, NConfig_Builder_Purpose purpose, std::function<void(size_t, NConfig_Meta, const std::string&)> metaCallback = {})
+	{
+		std::ostringstream oss;
+
+		const std::string patientStepping = Narrow_WString(Rat_Time_To_Default_WStr(stepping));
+
+		size_t curFilterIdx = 1;
+		std::string curFilterIdxStr;
+
+		Build_Filter_Idx_Str(curFilterIdx, curFilterIdxStr);
+
+		bool freshNewLine = true;
+		NDiscard_State discardState = NDiscard_State::No_Discard;
+
+		auto metaStrToEnum = [](const std::string& str) {
+
+			if (str == rsMeta_Opt_Filter)
+				return NConfig_Meta::Param_Opt_Filter;
+
+			return NConfig_Meta::None;
+		};
+
+		while (*citr != '\0')
+		{
+			if (freshNewLine)
+			{
+				// is a comment (may be meta comment); either way, remove the comment entirely
+				if (*citr == ';')
+				{
+					// meta marker
+					if (Match_And_Advance(&citr, rsMeta_Filter_Marker))
+					{
+						auto metastr = Read_Rest_Of_Line(&citr);
+						auto metas = Parse_Meta_String(metastr);
+
+						if (metas.find(rsMeta_All_Modes) != metas.end())
+							discardState = NDiscard_State::No_Discard;
+						else if ((metas.find(rsMeta_Gameplay) == metas.end() && purpose == NConfig_Builder_Purpose::Gameplay)
+							|| (metas.find(rsMeta_Optimalization) == metas.end() && purpose == NConfig_Builder_Purpose::Optimalization))
+							discardState = NDiscard_State::Follow_Up;
+						else
+							discardState = NDiscard_State::No_Discard;
+
+						// --- change against the original builder: rules added along with the headless purpose and binary and preloaded logs
+						if (purpose == NConfig_Builder_Purpose::Headless && metas.find(rsMeta_All_Modes) == metas.end() && metas.find(rsMeta_Headless) == metas.end())
+							discardState = NDiscard_State::Follow_Up;
+						if ((metas.find(rsMeta_Log_Source) != metas.end() && (logFilenameIn.empty() || Is_Binary_Log_Path(logFilenameIn)))
+							|| (metas.find(rsMeta_Log_Sink) != metas.end() && Is_Binary_Log_Path(logFilenameOut)))
+							discardState = NDiscard_State::Follow_Up;
+						// --- end of change
+
+						if (metaCallback)
+						{
+							for (auto& m : metas)
+							{
+								auto en = metaStrToEnum(m.first);
+								if (en != NConfig_Meta::None)
+									metaCallback(curFilterIdx - 1, en, m.second);
+							}
+						}
+					}
+					else
+						Discard_Rest_Of_Line(&citr);
+
+					continue;
+				}
+				else if (Match(&citr, rsFilter_Tag_Start))
+				{
+					if (discardState == NDiscard_State::Follow_Up)
+						discardState = NDiscard_State::Discard;
+					else
+						discardState = NDiscard_State::No_Discard;
+				}
+				else
+					freshNewLine = false;
+			}
+
+			if (discardState == NDiscard_State::No_Discard)
+			{
+				// placeholder begin markers
+				if (*citr == '{' && *(citr + 1) == '{')
+				{
+					if (Match_Replace_And_Advance(&citr, oss, rsPatient_Params_Placeholder, patientParams))
+						continue;
+
+					if (Match_Replace_And_Advance(&citr, oss, rsLog_File_Target_Placeholder, logFilenameOut))
+						continue;
+
+					if (Match_Replace_And_Advance(&citr, oss, rsLog_File_Source_Placeholder, logFilenameIn))
+						continue;
+
+					if (Match_Replace_And_Advance(&citr, oss, rsPatient_Model_Stepping_Placeholder, patientStepping))
+						continue;
+
+					// replace filter idx placeholder with newly evaluated index
+					if (Match_Replace_And_Advance(&citr, oss, rsFilter_Pos_Placeholder, curFilterIdxStr))
+					{
+						curFilterIdx++;
+						Build_Filter_Idx_Str(curFilterIdx, curFilterIdxStr);
+						continue;
+					}
+				}
+
+				oss << *citr;
+			}
+
+			if (*citr == '\r' || *citr == '\n')
+				freshNewLine = true;
+			else
+				freshNewLine = false;
+
+			citr++;
+		}
+
+		return oss.str();
+	}
+}
+
+namespace
+{
+	struct TLog_Kind
+	{
+		const char* name;
+		std::string log_in;
+		std::string log_out;
+	};
+
+	template <typename TBuilder>
+	double Measure_Per_Call_Us(size_t iterations, TBuilder&& builder)
+	{
+		size_t total_length = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			total_length += builder().length();
+		const auto end = std::chrono::steady_clock::now();
+
+		// keeps the optimizer from dropping the calls
+		if (total_length == 0)
+			std::cerr << "Empty configuration produced" << std::endl;
+
+		return std::chrono::duration<double, std::micro>(end - start).count() / static_cast<double>(iterations);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const size_t iterations = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000;
+	if (iterations == 0)
+	{
+		std::cerr << "Invalid iteration count" << std::endl;
+		return 1;
+	}
+
+	const double stepping = 5.0 * scgms::One_Minute;
+
+	const NConfig_Builder_Purpose purposes[] = { NConfig_Builder_Purpose::Gameplay, NConfig_Builder_Purpose::Optimalization, NConfig_Builder_Purpose::Replay, NConfig_Builder_Purpose::Headless };
+	const char* purpose_names[] = { "gameplay", "optimalization", "replay", "headless" };
+
+	// an empty input path stands for a log preloaded by the wrapper
+	const TLog_Kind log_kinds[] = {
+		{ "csv -> csv", "game_in.log", "game_out.log" },
+		{ "csv -> binary", "game_in.log", "game_out.sbl" },
+		{ "binary -> csv", "game_in.sbl", "game_out.log" },
+		{ "binary -> binary", "game_in.sbl", "game_out.sbl" },
+		{ "preloaded -> csv", "", "game_out.log" },
+		{ "preloaded -> binary", "", "game_out.sbl" },
+	};
+
+	size_t builtin_count = 0;
+	const TBuiltin_Config* builtins = Get_Builtin_Configs(builtin_count);
+
+	bool all_equal = true;
+
+	for (size_t p = 0; p < sizeof(purposes) / sizeof(purposes[0]); p++)
+	{
+		double baseline_us = 0, compiled_us = 0;
+		size_t measured = 0;
+
+		for (size_t b = 0; b < builtin_count; b++)
+		{
+			const GUID base_id = builtins[b].id;
+			const GUID parameters_id = Get_Config_Parameters_GUID(builtins[b].first_class, 1);
+
+			const char* templ = CConfig_Registry::Instance().Get_Template(base_id);
+			const std::string patient_params = CPatient_Registry::Instance().Get_Parameters_String(parameters_id);
+			if (!templ || patient_params.empty())
+			{
+				std::cerr << "Built-in config of class " << builtins[b].first_class << " is not available" << std::endl;
+				return 1;
+			}
+
+			for (const auto& kind : log_kinds)
+			{
+				const auto baseline_builder = [&]() { return baseline::Build_Config_From_Template(templ, patient_params, stepping, kind.log_in, kind.log_out, purposes[p]); };
+				const auto compiled_builder = [&]() { return Get_Config(base_id, parameters_id, stepping, kind.log_in, kind.log_out, purposes[p]); };
+
+				// also compiles the template, so that just the expansion is measured below
+				if (baseline_builder() != compiled_builder())
+				{
+					std::cerr << "Output differs: config class " << builtins[b].first_class << ", " << purpose_names[p] << ", " << kind.name << std::endl;
+					all_equal = false;
+					continue;
+				}
+
+				baseline_us += Measure_Per_Call_Us(iterations, baseline_builder);
+				compiled_us += Measure_Per_Call_Us(iterations, compiled_builder);
+				measured++;
+			}
+		}
+
+		if (measured > 0)
+		{
+			baseline_us /= static_cast<double>(measured);
+			compiled_us /= static_cast<double>(measured);
+
+			std::cout << purpose_names[p] << ": baseline " << baseline_us << " us/call, compiled " << compiled_us << " us/call ("
+				<< (baseline_us / compiled_us) << "x)" << std::endl;
+		}
+	}
+
+	return all_equal ? 0 : 1;
+}
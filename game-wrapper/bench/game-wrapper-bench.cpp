@@ -0,0 +1,214 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "../src/game-wrapper.h"
+#include "bench-stats.h"
+#include "bench-scenarios.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+	#include <Windows.h>
+	#include <psapi.h>
+#else
+	#include <fstream>
+	#include <unistd.h>
+#endif
+
+#undef min
+#undef max
+
+/*
+ * Step throughput and latency benchmark; drives headless sessions of each scenario of the config registry through the exported C API,
+ * with synthetic daily basal, meal and bolus schedule, at several model steppings
+ * Every run simulates the same time span, so the results of different steppings are comparable per simulated day
+ * Memory is reported as the growth of the resident set over the run, measured before the session is terminated; the peak resident set
+ * would be a high-water mark of the whole process, i.e.; of all the runs before
+ * Usage: game-wrapper-bench [simulated_days]
+ * Output: a JSON object per line, one for each scenario and stepping
+ */
+
+namespace
+{
+	const uint32_t Bench_Steppings_Ms[] = { 60 * 1000, 5 * 60 * 1000, 15 * 60 * 1000 };
+
+	// a single input of the daily schedule
+	struct TScheduled_Input
+	{
+		double minute_of_day;
+		const GUID* signal_id;
+		double level;
+	};
+
+	// basal rates in U/hr, meals in g of carbohydrates, boluses in U
+	const TScheduled_Input Daily_Schedule[] = {
+		{ 0.0,			&scgms::signal_Requested_Insulin_Basal_Rate,	0.9 },
+		{ 6 * 60.0,		&scgms::signal_Requested_Insulin_Basal_Rate,	1.2 },
+		{ 7 * 60.0,		&scgms::signal_Carb_Intake,						50.0 },
+		{ 7 * 60.0,		&scgms::signal_Requested_Insulin_Bolus,			5.0 },
+		{ 12.5 * 60.0,	&scgms::signal_Carb_Intake,						70.0 },
+		{ 12.5 * 60.0,	&scgms::signal_Requested_Insulin_Bolus,			7.0 },
+		{ 19 * 60.0,	&scgms::signal_Carb_Intake,						60.0 },
+		{ 19 * 60.0,	&scgms::signal_Requested_Insulin_Bolus,			6.0 },
+		{ 22 * 60.0,	&scgms::signal_Requested_Insulin_Basal_Rate,	0.8 },
+	};
+
+	constexpr double Minutes_Per_Day = 24 * 60.0;
+
+	// current resident set size of the process in kB
+	int64_t Current_RSS_KB()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+
+		return static_cast<int64_t>(counters.WorkingSetSize / 1024);
+#else
+		// the second field is the count of resident pages
+		std::ifstream statm("/proc/self/statm");
+		int64_t size_pages = 0, resident_pages = 0;
+		if (!(statm >> size_pages >> resident_pages))
+			return 0;
+
+		return resident_pages * static_cast<int64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#endif
+	}
+
+	bool Bench_Run(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, double simulated_days)
+	{
+		const double step_minutes = stepping_ms / 60000.0;
+		const size_t step_count = static_cast<size_t>(simulated_days * Minutes_Per_Day / step_minutes);
+
+		const int64_t rss_before_kb = Current_RSS_KB();
+
+		scgms_game_wrapper_t wrapper = scgms_game_create(config_class, config_id, stepping_ms, nullptr);
+		if (!wrapper)
+		{
+			std::cerr << "Could not create session of config " << config_class << ":" << config_id << std::endl;
+			return false;
+		}
+
+		std::vector<GUID> ids;
+		std::vector<double> levels, times;
+		std::vector<double> latencies_us;
+		latencies_us.reserve(step_count);
+
+		double bg, ig, iob, cob;
+		bool result = true;
+
+		const auto run_start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < step_count && result; i++)
+		{
+			// inputs falling into <step start; step end) of the daily schedule, as a fraction of the step
+			const double step_start = std::fmod(i * step_minutes, Minutes_Per_Day);
+
+			ids.clear();
+			levels.clear();
+			times.clear();
+
+			for (const auto& input : Daily_Schedule)
+			{
+				if (input.minute_of_day >= step_start && input.minute_of_day < step_start + step_minutes)
+				{
+					ids.push_back(*input.signal_id);
+					levels.push_back(input.level);
+					times.push_back((input.minute_of_day - step_start) / step_minutes);
+				}
+			}
+
+			const auto step_begin = std::chrono::steady_clock::now();
+			result = scgms_game_step(wrapper, ids.data(), levels.data(), times.data(), static_cast<uint32_t>(ids.size()), &bg, &ig, &iob, &cob) != FALSE;
+			const auto step_end = std::chrono::steady_clock::now();
+
+			latencies_us.push_back(std::chrono::duration<double, std::micro>(step_end - step_begin).count());
+		}
+
+		const double run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+
+		// measured while the session is still alive
+		const int64_t rss_delta_kb = Current_RSS_KB() - rss_before_kb;
+
+		scgms_game_terminate(wrapper);
+
+		if (!result)
+		{
+			std::cerr << "Step failed for config " << config_class << ":" << config_id << " at stepping " << stepping_ms << " ms" << std::endl;
+			return false;
+		}
+
+		std::cout << "{\"config_class\":" << config_class << ",\"config_id\":" << config_id
+			<< ",\"stepping_ms\":" << stepping_ms << ",\"steps\":" << step_count
+			<< ",\"steps_per_sec\":" << (step_count / run_seconds)
+			<< ",\"latency_us\":{\"p50\":" << Percentile(latencies_us, 0.5) << ",\"p90\":" << Percentile(latencies_us, 0.9)
+			<< ",\"p99\":" << Percentile(latencies_us, 0.99) << ",\"max\":" << Percentile(latencies_us, 1.0) << "}"
+			<< ",\"rss_delta_kb\":" << rss_delta_kb << "}" << std::endl;
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const double simulated_days = (argc > 1) ? std::strtod(argv[1], nullptr) : 3.0;
+	if (!(simulated_days > 0.0))
+	{
+		std::cerr << "Invalid count of simulated days" << std::endl;
+		return 1;
+	}
+
+	const auto scenarios = Get_Bench_Scenarios();
+	if (scenarios.empty())
+	{
+		std::cerr << "No scenario to benchmark" << std::endl;
+		return 1;
+	}
+
+	bool result = true;
+	for (const auto& scenario : scenarios)
+	{
+		for (const uint32_t stepping_ms : Bench_Steppings_Ms)
+			result &= Bench_Run(scenario.first, scenario.second, stepping_ms, simulated_days);
+	}
+
+	return result ? 0 : 2;
+}
@@ -0,0 +1,176 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "../src/game-wrapper.h"
+#include "bench-stats.h"
+#include "bench-scenarios.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Session start-up benchmark; repeatedly creates and terminates sessions of each config and reports p50/p99 of each start-up phase
+ * The first session of each config is reported separately, as it is the only one that expands and parses the configuration (later ones hit the cache)
+ * Sessions are headless, unless a log format (csv or sbl) is given; the log is then written to the temporary directory
+ * Without configs on the command line, each scenario of the config registry is benchmarked headless and with a CSV log
+ * Usage: game-wrapper-startup-bench [iterations] [config_class:config_id[:log_format] ...]
+ * Output: CSV lines "config_class,config_id,log_format,phase,cold_ms,p50_ms,p99_ms"
+ */
+
+namespace
+{
+	struct TBench_Config
+	{
+		uint16_t config_class;
+		uint16_t config_id;
+		// extension of the session log; empty for headless sessions
+		std::string log_format;
+	};
+
+	// log formats benchmarked by default; headless and logging through the chain
+	const char* Default_Log_Formats[] = { "", "csv" };
+
+	const char* Phase_Names[] = { "config_build", "config_parse", "chain_create", "segment_start", "initial_step", "total" };
+	static_assert(sizeof(Phase_Names) / sizeof(Phase_Names[0]) == static_cast<size_t>(NStartup_Phase::count), "Each start-up phase needs a name");
+
+	constexpr uint32_t Bench_Stepping_Ms = 5 * 60 * 1000;
+
+	bool Bench_Config(const TBench_Config& config, size_t iterations)
+	{
+		constexpr size_t phase_count = static_cast<size_t>(NStartup_Phase::count);
+
+		std::vector<std::vector<double>> samples(phase_count);
+		double cold[phase_count] = {};
+
+		std::string log_file_path;
+		if (!config.log_format.empty())
+			log_file_path = (std::filesystem::temp_directory_path() / ("game-wrapper-startup-bench." + config.log_format)).string();
+
+		for (size_t i = 0; i < iterations; i++)
+		{
+			scgms_game_wrapper_t wrapper = scgms_game_create(config.config_class, config.config_id, Bench_Stepping_Ms, log_file_path.empty() ? nullptr : log_file_path.c_str());
+			if (!wrapper)
+			{
+				std::cerr << "Could not create session of config " << config.config_class << ":" << config.config_id << ":" << config.log_format << std::endl;
+				return false;
+			}
+
+			double durations[phase_count];
+			const BOOL profiled = scgms_game_get_startup_profile(wrapper, durations, static_cast<uint32_t>(phase_count));
+
+			scgms_game_terminate(wrapper);
+
+			if (!log_file_path.empty())
+			{
+				std::error_code ec;
+				std::filesystem::remove(log_file_path, ec);
+			}
+
+			if (!profiled)
+				return false;
+
+			for (size_t p = 0; p < phase_count; p++)
+			{
+				if (i == 0)
+					cold[p] = durations[p];
+				else
+					samples[p].push_back(durations[p]);
+			}
+		}
+
+		for (size_t p = 0; p < phase_count; p++)
+		{
+			std::cout << config.config_class << "," << config.config_id << "," << config.log_format << "," << Phase_Names[p] << "," << cold[p] << ","
+				<< Percentile(samples[p], 0.5) << "," << Percentile(samples[p], 0.99) << std::endl;
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const size_t iterations = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100;
+	if (iterations < 2)
+	{
+		std::cerr << "At least 2 iterations are needed" << std::endl;
+		return 1;
+	}
+
+	std::vector<TBench_Config> configs;
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const size_t delim = arg.find(':');
+		if (delim == std::string::npos)
+		{
+			std::cerr << "Invalid config specification: " << arg << std::endl;
+			return 1;
+		}
+
+		const size_t format_delim = arg.find(':', delim + 1);
+		const std::string log_format = (format_delim == std::string::npos) ? std::string{} : arg.substr(format_delim + 1);
+
+		configs.push_back({ static_cast<uint16_t>(std::stoul(arg.substr(0, delim))), static_cast<uint16_t>(std::stoul(arg.substr(delim + 1, format_delim - delim - 1))), log_format });
+	}
+
+	if (configs.empty())
+	{
+		for (const char* log_format : Default_Log_Formats)
+		{
+			for (const auto& scenario : Get_Bench_Scenarios())
+				configs.push_back({ scenario.first, scenario.second, log_format });
+		}
+
+		if (configs.empty())
+		{
+			std::cerr << "No scenario to benchmark" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "config_class,config_id,log_format,phase,cold_ms,p50_ms,p99_ms" << std::endl;
+
+	bool result = true;
+	for (const auto& config : configs)
+		result &= Bench_Config(config, iterations);
+
+	return result ? 0 : 2;
+}
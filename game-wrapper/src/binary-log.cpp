@@ -0,0 +1,414 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "binary-log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#undef min
+#undef max
+
+// count of records buffered by the writer before they are written to the file
+constexpr const size_t Writer_Buffer_Record_Count = 4096;
+
+bool Is_Binary_Log_Path(const std::string& path)
+{
+	return std::filesystem::path{ path }.extension() == Binary_Log_Extension;
+}
+
+bool Is_Binary_Log_Event(scgms::NDevice_Event_Code code)
+{
+	switch (code)
+	{
+		// these carry text or arrays, which do not fit into a record
+		case scgms::NDevice_Event_Code::Parameters:
+		case scgms::NDevice_Event_Code::Parameters_Hint:
+		case scgms::NDevice_Event_Code::Information:
+		case scgms::NDevice_Event_Code::Warning:
+		case scgms::NDevice_Event_Code::Error:
+		// the end of the log marks the end of the replay
+		case scgms::NDevice_Event_Code::Shut_Down:
+			return false;
+		default:
+			return true;
+	}
+}
+
+bool To_Binary_Log_Record(scgms::UDevice_Event& evt, TBinary_Log_Record& rec)
+{
+	if (!Is_Binary_Log_Event(evt.event_code()))
+		return false;
+
+	rec = TBinary_Log_Record{};
+	rec.device_time = evt.device_time();
+	rec.level = evt.level();
+	rec.signal_id = evt.signal_id();
+	rec.device_id = evt.device_id();
+	rec.segment_id = evt.segment_id();
+	rec.event_code = static_cast<uint32_t>(evt.event_code());
+
+	return true;
+}
+
+CLog_Time_Index::CLog_Time_Index(size_t stride) : mStride(std::max<size_t>(1, stride))
+{
+	//
+}
+
+void CLog_Time_Index::Clear()
+{
+	mEntries.clear();
+	mMax_Time = -std::numeric_limits<double>::infinity();
+	mRecord_Count = 0;
+}
+
+void CLog_Time_Index::Add(double device_time)
+{
+	if (mRecord_Count % mStride == 0)
+		mEntries.push_back(TBinary_Log_Index_Entry{ mMax_Time, static_cast<uint64_t>(mRecord_Count) });
+
+	mMax_Time = std::max(mMax_Time, device_time);
+	mRecord_Count++;
+}
+
+void CLog_Time_Index::Build(const TBinary_Log_Record* begin, const TBinary_Log_Record* end)
+{
+	Clear();
+
+	mEntries.reserve(static_cast<size_t>(end - begin) / mStride + 1);
+
+	for (auto itr = begin; itr != end; itr++)
+		Add(itr->device_time);
+}
+
+bool CLog_Time_Index::Assign(const TBinary_Log_Index_Entry* begin, const TBinary_Log_Index_Entry* end, size_t stride, size_t record_count)
+{
+	Clear();
+
+	// the index comes from the file, so it must not point past the records, and both fields must be non-decreasing for the binary search to work
+	for (auto itr = begin; itr != end; itr++)
+	{
+		if (itr->record_index > record_count)
+			return false;
+
+		if (itr != begin && (itr->record_index < std::prev(itr)->record_index || !(itr->max_time >= std::prev(itr)->max_time)))
+			return false;
+	}
+
+	mStride = std::max<size_t>(1, stride);
+	mEntries.assign(begin, end);
+
+	return true;
+}
+
+bool CLog_Time_Index::Empty() const
+{
+	return mEntries.empty();
+}
+
+size_t CLog_Time_Index::Stride() const
+{
+	return mStride;
+}
+
+const std::vector<TBinary_Log_Index_Entry>& CLog_Time_Index::Entries() const
+{
+	return mEntries;
+}
+
+size_t CLog_Time_Index::Seek(const TBinary_Log_Record* records, size_t count, double time) const
+{
+	// the last entry, that guarantees no record preceding it is at or after the time
+	auto itr = std::lower_bound(mEntries.begin(), mEntries.end(), time, [](const TBinary_Log_Index_Entry& entry, double t) {
+		return entry.max_time < t;
+	});
+
+	size_t pos = 0;
+	if (itr != mEntries.begin())
+		pos = std::min(count, static_cast<size_t>(std::prev(itr)->record_index));
+
+	// the rest is within a single stride, unless records are heavily out of order
+	while (pos < count && records[pos].device_time < time)
+		pos++;
+
+	return pos;
+}
+
+CBinary_Log_Writer::~CBinary_Log_Writer()
+{
+	Close();
+}
+
+bool CBinary_Log_Writer::Open(const std::string& path)
+{
+	Close();
+
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+	if (!mFile.is_open())
+		return false;
+
+	TBinary_Log_Header header{};
+	std::memcpy(header.magic, Binary_Log_Magic, sizeof(header.magic));
+	header.version = Binary_Log_Version;
+	header.record_size = sizeof(TBinary_Log_Record);
+
+	mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	mPending.reserve(Writer_Buffer_Record_Count);
+	mIndex.Clear();
+
+	return mFile.good();
+}
+
+void CBinary_Log_Writer::Write(scgms::UDevice_Event& evt)
+{
+	if (!mFile.is_open())
+		return;
+
+	// flush on shut down, so the file is complete once the chain terminates
+	if (evt.event_code() == scgms::NDevice_Event_Code::Shut_Down)
+	{
+		Flush();
+		return;
+	}
+
+	TBinary_Log_Record rec;
+	if (!To_Binary_Log_Record(evt, rec))
+		return;
+
+	mPending.push_back(rec);
+	mIndex.Add(rec.device_time);
+
+	if (mPending.size() >= Writer_Buffer_Record_Count)
+		Flush();
+}
+
+void CBinary_Log_Writer::Flush()
+{
+	if (mPending.empty() || !mFile.is_open())
+		return;
+
+	mFile.write(reinterpret_cast<const char*>(mPending.data()), static_cast<std::streamsize>(mPending.size() * sizeof(TBinary_Log_Record)));
+	mFile.flush();
+
+	mPending.clear();
+}
+
+void CBinary_Log_Writer::Close()
+{
+	if (!mFile.is_open())
+		return;
+
+	Flush();
+
+	// append the index and let the header point to it
+	const auto& entries = mIndex.Entries();
+	const uint64_t index_offset = static_cast<uint64_t>(mFile.tellp());
+
+	mFile.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TBinary_Log_Index_Entry)));
+
+	TBinary_Log_Header header{};
+	std::memcpy(header.magic, Binary_Log_Magic, sizeof(header.magic));
+	header.version = Binary_Log_Version;
+	header.record_size = sizeof(TBinary_Log_Record);
+	header.index_offset = index_offset;
+	header.index_stride = mIndex.Stride();
+
+	mFile.seekp(0);
+	mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	mFile.close();
+}
+
+CBinary_Log_Reader::~CBinary_Log_Reader()
+{
+	Close();
+}
+
+bool CBinary_Log_Reader::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	const std::wstring wpath = std::filesystem::path{ path }.wstring();
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(TBinary_Log_Header)))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mFile_Handle = file;
+	mMapping_Handle = mapping;
+	mMapping = view;
+	mMapping_Size = static_cast<size_t>(file_size.QuadPart);
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TBinary_Log_Header)))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return false;
+
+	// replays read the log from the beginning to the end
+	madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+	mMapping = view;
+	mMapping_Size = static_cast<size_t>(st.st_size);
+#endif
+
+	const TBinary_Log_Header* header = static_cast<const TBinary_Log_Header*>(mMapping);
+	if (std::memcmp(header->magic, Binary_Log_Magic, sizeof(header->magic)) != 0 || header->version != Binary_Log_Version || header->record_size != sizeof(TBinary_Log_Record))
+	{
+		Close();
+		return false;
+	}
+
+	const uint8_t* base = static_cast<const uint8_t*>(mMapping);
+	mRecords = reinterpret_cast<const TBinary_Log_Record*>(base + sizeof(TBinary_Log_Header));
+
+	// records end where the index starts; without the index, a partially written record at the end (e.g.; after a crash) is ignored
+	const bool has_index = header->index_offset >= sizeof(TBinary_Log_Header) && header->index_offset <= mMapping_Size;
+	const size_t records_end = has_index ? static_cast<size_t>(header->index_offset) : mMapping_Size;
+
+	mRecord_Count = (records_end - sizeof(TBinary_Log_Header)) / sizeof(TBinary_Log_Record);
+
+	mIndex.Clear();
+	if (has_index)
+	{
+		const size_t entry_count = (mMapping_Size - records_end) / sizeof(TBinary_Log_Index_Entry);
+		const TBinary_Log_Index_Entry* entries = reinterpret_cast<const TBinary_Log_Index_Entry*>(base + records_end);
+
+		// an inconsistent index is ignored; it gets rebuilt from the records on the first seek
+		mIndex.Assign(entries, entries + entry_count, static_cast<size_t>(header->index_stride), mRecord_Count);
+	}
+
+	return true;
+}
+
+void CBinary_Log_Reader::Close()
+{
+	if (mMapping)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mMapping);
+		CloseHandle(mMapping_Handle);
+		CloseHandle(mFile_Handle);
+
+		mMapping_Handle = nullptr;
+		mFile_Handle = nullptr;
+#else
+		munmap(mMapping, mMapping_Size);
+#endif
+	}
+
+	mMapping = nullptr;
+	mMapping_Size = 0;
+	mRecords = nullptr;
+	mRecord_Count = 0;
+	mIndex.Clear();
+}
+
+size_t CBinary_Log_Reader::Seek(double time)
+{
+	if (mIndex.Empty())
+		mIndex.Build(begin(), end());
+
+	return mIndex.Seek(mRecords, mRecord_Count, time);
+}
+
+bool CBinary_Log_Sink::Open(const std::string& path)
+{
+	return mWriter.Open(path);
+}
+
+HRESULT IfaceCalling CBinary_Log_Sink::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT IfaceCalling CBinary_Log_Sink::Execute(scgms::IDevice_Event *event)
+{
+	scgms::UDevice_Event evt{ event };
+
+	mWriter.Write(evt);
+
+	return S_OK;
+}
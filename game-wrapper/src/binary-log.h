@@ -0,0 +1,232 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/iface/referencedIface.h>
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+ * Compact binary game log
+ * The file consists of a header followed by fixed-size records in the order the events were emitted; all values are stored in the native (little-endian) byte order
+ * Only events with scalar payload are stored (levels, segment markers, ...); events carrying text or parameter arrays are left out
+ * A properly closed log ends with a sparse time index (footer) of its records; logs without the index (e.g.; after a crash) get indexed when first seeked
+ */
+
+// log files with this extension are written and read in the binary format instead of CSV
+constexpr const char* Binary_Log_Extension = ".sbl";
+
+constexpr const char Binary_Log_Magic[8] = { 'S', 'C', 'G', 'M', 'S', 'B', 'L', '\0' };
+constexpr const uint32_t Binary_Log_Version = 1;
+
+// count of records covered by a single time index entry
+constexpr const size_t Default_Log_Index_Stride = 1024;
+
+struct TBinary_Log_Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	// file offset of the time index; zero if the log has no index
+	uint64_t index_offset;
+	// count of records covered by a single index entry
+	uint64_t index_stride;
+};
+
+struct TBinary_Log_Record
+{
+	double device_time;
+	double level;
+	GUID signal_id;
+	GUID device_id;
+	uint64_t segment_id;
+	uint32_t event_code;
+	uint32_t reserved;
+};
+
+// a single entry of the time index; all records preceding the record_index one have device time lower or equal to max_time
+struct TBinary_Log_Index_Entry
+{
+	double max_time;
+	uint64_t record_index;
+};
+
+static_assert(sizeof(TBinary_Log_Header) == 32, "Binary log header must be 32 bytes long");
+static_assert(sizeof(TBinary_Log_Record) == 64, "Binary log record must be 64 bytes long");
+static_assert(sizeof(TBinary_Log_Index_Entry) == 16, "Binary log index entry must be 16 bytes long");
+
+/*
+ * Sparse time index of log records; an entry per stride records allows to find the start of a replay in O(log n)
+ * Records need not to be sorted by time, as the entries store running maximum of device times
+ */
+class CLog_Time_Index
+{
+	private:
+		std::vector<TBinary_Log_Index_Entry> mEntries;
+		size_t mStride = Default_Log_Index_Stride;
+		double mMax_Time = -std::numeric_limits<double>::infinity();
+		size_t mRecord_Count = 0;
+
+	public:
+		CLog_Time_Index(size_t stride = Default_Log_Index_Stride);
+
+		// indexes given records from scratch
+		void Build(const TBinary_Log_Record* begin, const TBinary_Log_Record* end);
+		// uses entries stored in a log file, that indexes record_count records; returns false and leaves the index empty, if the entries are inconsistent
+		bool Assign(const TBinary_Log_Index_Entry* begin, const TBinary_Log_Index_Entry* end, size_t stride, size_t record_count);
+		// appends a record to the index; used while the log is being written
+		void Add(double device_time);
+
+		void Clear();
+		bool Empty() const;
+		size_t Stride() const;
+		const std::vector<TBinary_Log_Index_Entry>& Entries() const;
+
+		// retrieves index of the first record not earlier than given time; returns count if there is no such record
+		size_t Seek(const TBinary_Log_Record* records, size_t count, double time) const;
+};
+
+// does the given path select the binary log format?
+bool Is_Binary_Log_Path(const std::string& path);
+
+// is the event stored in binary logs?
+bool Is_Binary_Log_Event(scgms::NDevice_Event_Code code);
+
+// converts the event to a binary log record; returns false if the event is not stored in binary logs
+bool To_Binary_Log_Record(scgms::UDevice_Event& evt, TBinary_Log_Record& rec);
+
+/*
+ * Buffered writer of binary game logs
+ */
+class CBinary_Log_Writer
+{
+	private:
+		std::ofstream mFile;
+		std::vector<TBinary_Log_Record> mPending;
+		CLog_Time_Index mIndex;
+
+	public:
+		CBinary_Log_Writer() = default;
+		virtual ~CBinary_Log_Writer();
+
+		// creates (truncates) the log file and writes its header
+		bool Open(const std::string& path);
+		// stores the event, if it is of a type stored in binary logs
+		void Write(scgms::UDevice_Event& evt);
+		// writes all buffered records to the file
+		void Flush();
+		// writes remaining records and the time index
+		void Close();
+};
+
+/*
+ * Memory-mapped read-only view of a binary game log
+ */
+class CBinary_Log_Reader
+{
+	private:
+		const TBinary_Log_Record* mRecords = nullptr;
+		size_t mRecord_Count = 0;
+		// built on first seek, unless stored in the file
+		CLog_Time_Index mIndex;
+
+		void* mMapping = nullptr;
+		size_t mMapping_Size = 0;
+#ifdef _WIN32
+		void* mFile_Handle = nullptr;
+		void* mMapping_Handle = nullptr;
+#endif
+
+	public:
+		CBinary_Log_Reader() = default;
+		CBinary_Log_Reader(const CBinary_Log_Reader&) = delete;
+		CBinary_Log_Reader& operator=(const CBinary_Log_Reader&) = delete;
+		virtual ~CBinary_Log_Reader();
+
+		// maps the log file to memory and validates its header
+		bool Open(const std::string& path);
+		void Close();
+
+		size_t Size() const
+		{
+			return mRecord_Count;
+		}
+
+		const TBinary_Log_Record* begin() const
+		{
+			return mRecords;
+		}
+
+		const TBinary_Log_Record* end() const
+		{
+			return mRecords + mRecord_Count;
+		}
+
+		// retrieves index of the first record not earlier than given time
+		size_t Seek(double time);
+};
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Terminal filter of a chain, which stores all events to a binary log
+ */
+class CBinary_Log_Sink : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
+{
+	private:
+		CBinary_Log_Writer mWriter;
+
+	public:
+		CBinary_Log_Sink() = default;
+		virtual ~CBinary_Log_Sink() = default;
+
+		bool Open(const std::string& path);
+
+		// scgms::IFilter iface
+		virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description);
+		virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event);
+};
+
+#pragma warning( pop )
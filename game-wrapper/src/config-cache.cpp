@@ -0,0 +1,171 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "config-cache.h"
+#include "binary-log.h"
+
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/utils/string_utils.h>
+
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
+// name of log file path parameter of the CSV log filter
+constexpr const wchar_t* rsLog_File_Parameter = L"Log_File";
+
+std::shared_ptr<TParsed_Configuration> Parse_Configuration(const std::string& contents, size_t log_filter_idx, refcnt::Swstr_list& errors)
+{
+	auto parsed = std::make_shared<TParsed_Configuration>();
+	parsed->contents = contents;
+
+	if (!parsed->configuration || parsed->configuration->Load_From_Memory(contents.c_str(), contents.length(), errors.get()) != S_OK)
+		return nullptr;
+
+	if (log_filter_idx != std::string::npos)
+	{
+		parsed->log_file_parameter = Find_Filter_Parameter(parsed->configuration, log_filter_idx, rsLog_File_Parameter);
+		if (!parsed->log_file_parameter)
+			return nullptr;
+	}
+
+	return parsed;
+}
+
+scgms::SFilter_Parameter Find_Filter_Parameter(scgms::SPersistent_Filter_Chain_Configuration& configuration, size_t filter_idx, const std::wstring& name)
+{
+	scgms::IFilter_Configuration_Link** begin, ** end;
+	configuration->get(&begin, &end);
+
+	if (begin + filter_idx >= end)
+		return {};
+
+	auto link = begin + filter_idx;
+
+	scgms::IFilter_Parameter** pbegin, ** pend;
+	(*link)->get(&pbegin, &pend);
+
+	for (; pbegin != pend; pbegin++)
+	{
+		scgms::SFilter_Parameter sparam = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*pbegin, true);
+
+		auto cname = sparam.configuration_name();
+
+		if (std::wstring_view{ cname } == name)
+			return sparam;
+	}
+
+	return {};
+}
+
+bool CConfiguration_Cache::TKey::operator==(const TKey& other) const
+{
+	return config_id == other.config_id && parameters_id == other.parameters_id && stepping == other.stepping && purpose == other.purpose && binary_log == other.binary_log && profiled == other.profiled;
+}
+
+size_t CConfiguration_Cache::TKey_Hash::operator()(const TKey& key) const
+{
+	uint64_t ids[4];
+	std::memcpy(ids, &key.config_id, sizeof(GUID));
+	std::memcpy(ids + 2, &key.parameters_id, sizeof(GUID));
+
+	size_t h = std::hash<double>{}(key.stepping);
+	for (const uint64_t id : ids)
+		h = h * 31 + std::hash<uint64_t>{}(id);
+
+	return h * 31 + static_cast<size_t>(key.purpose) * 4 + (key.binary_log ? 2 : 0) + (key.profiled ? 1 : 0);
+}
+
+CConfiguration_Cache& CConfiguration_Cache::Instance()
+{
+	static CConfiguration_Cache instance;
+	return instance;
+}
+
+std::shared_ptr<TParsed_Configuration> CConfiguration_Cache::Get(const GUID& config_id, const GUID& parameters_id, double stepping, NConfig_Builder_Purpose purpose, bool binary_log, bool profiled, refcnt::Swstr_list& errors, TConfiguration_Timing* timing)
+{
+	const TKey key{ config_id, parameters_id, stepping, purpose, binary_log, profiled };
+
+	{
+		std::lock_guard<std::mutex> lck(mMtx);
+
+		auto itr = mEntries.find(key);
+		if (itr != mEntries.end())
+			return itr->second;
+	}
+
+	// the log path is patched by each session; for binary logs, any binary path makes the builder leave the CSV log filter out
+	const std::string log_file_path = binary_log ? std::string{ "cached" } + Binary_Log_Extension : std::string{};
+
+	const auto build_start = std::chrono::steady_clock::now();
+
+	size_t log_filter_idx = std::string::npos;
+	const std::string contents = Get_Config(config_id, parameters_id, stepping, log_file_path, log_file_path, purpose,
+		[&log_filter_idx](size_t idx, NConfig_Meta meta, const std::string& val) {
+			if (meta == NConfig_Meta::Log_Sink)
+				log_filter_idx = idx;
+		},
+		profiled
+	);
+
+	if (contents.empty())
+		return nullptr;
+
+	const auto parse_start = std::chrono::steady_clock::now();
+
+	// parse outside of the lock, so other configurations are not blocked meanwhile; a concurrent first request just parses in vain
+	auto parsed = Parse_Configuration(contents, log_filter_idx, errors);
+	if (!parsed)
+		return nullptr;
+
+	if (timing)
+	{
+		const auto parse_end = std::chrono::steady_clock::now();
+
+		timing->build_ms = std::chrono::duration<double, std::milli>(parse_start - build_start).count();
+		timing->parse_ms = std::chrono::duration<double, std::milli>(parse_end - parse_start).count();
+	}
+
+	std::lock_guard<std::mutex> lck(mMtx);
+	return mEntries.emplace(key, parsed).first->second;
+}
+
+void CConfiguration_Cache::Clear()
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+	mEntries.clear();
+}
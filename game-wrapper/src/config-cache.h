@@ -0,0 +1,119 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/iface/referencedIface.h>
+
+#include "configs.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+ * Parsed filter chain configuration, shared by all sessions created with the same parameters
+ * Executors read the configuration just while they are being created, so the log file path is patched and the executor created under the lock
+ */
+struct TParsed_Configuration
+{
+	// the configuration text; kept for inspection of the chain
+	std::string contents;
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	// log file path parameter of the CSV log filter; empty if there is no such filter
+	scgms::SFilter_Parameter log_file_parameter;
+
+	std::mutex mtx;
+};
+
+// durations of configuration retrieval phases in milliseconds; both are zero, if the configuration was taken from the cache
+struct TConfiguration_Timing
+{
+	double build_ms = 0.0;
+	double parse_ms = 0.0;
+};
+
+// parses given configuration text; log_filter_idx is index of the CSV log filter, or npos if there is none
+std::shared_ptr<TParsed_Configuration> Parse_Configuration(const std::string& contents, size_t log_filter_idx, refcnt::Swstr_list& errors);
+
+// finds parameter of given configuration name in given filter of the configuration; returns empty parameter if not found
+scgms::SFilter_Parameter Find_Filter_Parameter(scgms::SPersistent_Filter_Chain_Configuration& configuration, size_t filter_idx, const std::wstring& name);
+
+/*
+ * Process-wide cache of parsed gameplay configurations
+ * Sessions of the same configuration, patient, stepping and kind of log share a single parsed configuration, so that the template expansion
+ * and parsing is performed just once
+ */
+class CConfiguration_Cache
+{
+	private:
+		struct TKey
+		{
+			GUID config_id;
+			GUID parameters_id;
+			double stepping;
+			NConfig_Builder_Purpose purpose;
+			bool binary_log;
+			bool profiled;
+
+			bool operator==(const TKey& other) const;
+		};
+
+		struct TKey_Hash
+		{
+			size_t operator()(const TKey& key) const;
+		};
+
+		std::mutex mMtx;
+		std::unordered_map<TKey, std::shared_ptr<TParsed_Configuration>, TKey_Hash> mEntries;
+
+		CConfiguration_Cache() = default;
+
+	public:
+		static CConfiguration_Cache& Instance();
+
+		// retrieves parsed configuration; builds and parses it on the first request
+		// binary_log indicates, that the session writes binary log, i.e.; the CSV log filter is left out; profiled selects the config with profiling probes
+		// timing, if given, receives durations of the template expansion and parsing
+		std::shared_ptr<TParsed_Configuration> Get(const GUID& config_id, const GUID& parameters_id, double stepping, NConfig_Builder_Purpose purpose, bool binary_log, bool profiled, refcnt::Swstr_list& errors, TConfiguration_Timing* timing = nullptr);
+
+		// drops all cached configurations; sessions keep using the ones they already hold
+		void Clear();
+};
@@ -0,0 +1,287 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "config-registry.h"
+#include "configs.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static uint64_t Make_Scenario_Key(uint32_t config_class, uint32_t config_id)
+{
+	return (static_cast<uint64_t>(config_class) << 32) | config_id;
+}
+
+static bool Parse_Catalogue_GUID(const std::string& str, GUID& id)
+{
+	bool ok = false;
+	id = WString_To_GUID(Widen_String(str), ok);
+	return ok;
+}
+
+CConfig_Registry::CConfig_Registry()
+{
+	size_t count = 0;
+	const TBuiltin_Config* builtins = Get_Builtin_Configs(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		TTemplate& templ = mTemplates[builtins[i].id];
+		templ.builtin = builtins[i].templ;
+
+		for (uint32_t config_class = builtins[i].first_class; config_class <= builtins[i].last_class; config_class++)
+			mClass_Defaults[config_class] = TConfig_Scenario{ builtins[i].id, Invalid_GUID };
+	}
+}
+
+CConfig_Registry& CConfig_Registry::Instance()
+{
+	static CConfig_Registry registry;
+	return registry;
+}
+
+bool CConfig_Registry::Load_Catalogue(const std::string& path)
+{
+	const std::filesystem::path catalogue_path{ path };
+
+	std::error_code ec;
+	if (!std::filesystem::is_directory(catalogue_path, ec))
+		return Load_Catalogue_File(catalogue_path);
+
+	// load in a deterministic order, so later catalogues override earlier ones predictably
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator(catalogue_path, ec))
+	{
+		if (entry.is_regular_file(ec) && entry.path().extension() == Config_Catalogue_Extension)
+			files.push_back(entry.path());
+	}
+
+	if (ec || files.empty())
+		return false;
+
+	std::sort(files.begin(), files.end());
+
+	bool result = true;
+	for (const auto& file : files)
+		result &= Load_Catalogue_File(file);
+
+	return result;
+}
+
+bool CConfig_Registry::Load_Catalogue_File(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
+
+	// parse the whole catalogue first; nothing is registered if any line is invalid
+	std::vector<std::pair<GUID, std::filesystem::path>> templates;
+	std::vector<std::pair<uint64_t, TConfig_Scenario>> scenarios;
+	std::vector<std::pair<uint32_t, TConfig_Scenario>> class_defaults;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream iss(line);
+
+		std::string keyword;
+		if (!(iss >> keyword) || keyword[0] == ';')
+			continue;
+
+		if (keyword == "template")
+		{
+			std::string id_str, file_str;
+			GUID id;
+			if (!(iss >> id_str) || !Parse_Catalogue_GUID(id_str, id))
+				return false;
+
+			// the path is the rest of the line, so it may contain spaces
+			std::getline(iss >> std::ws, file_str);
+			while (!file_str.empty() && (file_str.back() == '\r' || file_str.back() == ' ' || file_str.back() == '\t'))
+				file_str.pop_back();
+
+			if (file_str.empty())
+				return false;
+
+			std::filesystem::path template_path{ file_str };
+			if (template_path.is_relative())
+				template_path = path.parent_path() / template_path;
+
+			templates.emplace_back(id, template_path);
+		}
+		else if (keyword == "scenario")
+		{
+			uint32_t config_class;
+			std::string id_str, config_str, patient_str;
+			TConfig_Scenario scenario;
+
+			if (!(iss >> config_class >> id_str >> config_str) || !Parse_Catalogue_GUID(config_str, scenario.config_id))
+				return false;
+
+			if ((iss >> patient_str) && !Parse_Catalogue_GUID(patient_str, scenario.parameters_id))
+				return false;
+
+			if (id_str == "*")
+				class_defaults.emplace_back(config_class, scenario);
+			else
+			{
+				char* end = nullptr;
+				const unsigned long config_id = std::strtoul(id_str.c_str(), &end, 10);
+				if (end == id_str.c_str() || *end != '\0')
+					return false;
+
+				scenarios.emplace_back(Make_Scenario_Key(config_class, static_cast<uint32_t>(config_id)), scenario);
+			}
+		}
+		else
+			return false;
+	}
+
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	// template GUIDs are immutable - compiled templates and cached configurations refer to them
+	for (const auto& templ : templates)
+	{
+		auto itr = mTemplates.find(templ.first);
+		if (itr != mTemplates.end() && (itr->second.builtin || itr->second.file != templ.second))
+			return false;
+	}
+
+	// scenarios must refer to known templates
+	auto is_known = [&](const TConfig_Scenario& scenario) {
+		return mTemplates.find(scenario.config_id) != mTemplates.end()
+			|| std::any_of(templates.begin(), templates.end(), [&](const auto& templ) { return templ.first == scenario.config_id; });
+	};
+
+	for (const auto& scenario : scenarios)
+	{
+		if (!is_known(scenario.second))
+			return false;
+	}
+	for (const auto& scenario : class_defaults)
+	{
+		if (!is_known(scenario.second))
+			return false;
+	}
+
+	// just the file path is registered now; the template itself is loaded on first use
+	for (const auto& templ : templates)
+		mTemplates[templ.first].file = templ.second;
+
+	for (const auto& scenario : scenarios)
+		mScenarios[scenario.first] = scenario.second;
+	for (const auto& scenario : class_defaults)
+		mClass_Defaults[scenario.first] = scenario.second;
+
+	return true;
+}
+
+bool CConfig_Registry::Find_Scenario(uint32_t config_class, uint32_t config_id, TConfig_Scenario& scenario) const
+{
+	// copied under the lock, as loading a catalogue may rehash the maps
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	auto itr = mScenarios.find(Make_Scenario_Key(config_class, config_id));
+	if (itr != mScenarios.end())
+	{
+		scenario = itr->second;
+		return true;
+	}
+
+	auto class_itr = mClass_Defaults.find(config_class);
+	if (class_itr != mClass_Defaults.end())
+	{
+		scenario = class_itr->second;
+		return true;
+	}
+
+	return false;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> CConfig_Registry::Get_Scenario_Ids() const
+{
+	std::vector<std::pair<uint32_t, uint32_t>> ids;
+
+	{
+		std::lock_guard<std::mutex> lck(mMtx);
+
+		for (const auto& scenario : mScenarios)
+			ids.emplace_back(static_cast<uint32_t>(scenario.first >> 32), static_cast<uint32_t>(scenario.first & 0xFFFFFFFF));
+		for (const auto& scenario : mClass_Defaults)
+			ids.emplace_back(scenario.first, 1);
+	}
+
+	// a class may have both its own scenario for config ID 1 and a class-wide one
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+	return ids;
+}
+
+const char* CConfig_Registry::Get_Template(const GUID& config_id)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	auto itr = mTemplates.find(config_id);
+	if (itr == mTemplates.end())
+		return nullptr;
+
+	TTemplate& templ = itr->second;
+	if (templ.builtin)
+		return templ.builtin;
+
+	if (!templ.loaded)
+	{
+		std::ifstream file(templ.file, std::ios::binary);
+		if (!file.is_open())
+			return nullptr;
+
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		if (file.bad())
+			return nullptr;
+
+		templ.loaded = std::make_unique<std::string>(contents.str());
+	}
+
+	return templ.loaded->c_str();
+}
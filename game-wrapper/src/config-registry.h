@@ -0,0 +1,109 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/rtl/guid.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * Registry of game scenarios; maps config class and config ID to the config template and the patient
+ * Built-in templates are always present, further scenarios come from catalogue files
+ *
+ * A catalogue is a text file with one declaration per line; empty lines and lines starting with ';' are ignored:
+ *		template {template GUID} <template file path, relative to the catalogue>
+ *		scenario <config class> <config ID or *> {template GUID} [{patient GUID}]
+ * A scenario with '*' as config ID applies to all config IDs of the class, that have no scenario of their own
+ * A scenario without patient GUID selects the patient by config class and config ID in the patient registry
+ */
+
+// catalogue files are expected to use this extension; a catalogue directory is searched for files with it
+constexpr const char* Config_Catalogue_Extension = ".catalogue";
+
+struct TConfig_Scenario
+{
+	GUID config_id = Invalid_GUID;
+	GUID parameters_id = Invalid_GUID;
+};
+
+class CConfig_Registry
+{
+	private:
+		struct TTemplate
+		{
+			// built-in template text; nullptr for templates stored in files
+			const char* builtin = nullptr;
+			std::filesystem::path file;
+			// contents of the file, loaded on first use; never released, as compiled templates refer to it
+			std::unique_ptr<std::string> loaded;
+		};
+
+		mutable std::mutex mMtx;
+		// (config class << 32 | config ID) -> scenario
+		std::unordered_map<uint64_t, TConfig_Scenario> mScenarios;
+		// config class -> scenario used for config IDs without own scenario
+		std::unordered_map<uint32_t, TConfig_Scenario> mClass_Defaults;
+		std::map<GUID, TTemplate> mTemplates;
+
+		CConfig_Registry();
+
+		bool Load_Catalogue_File(const std::filesystem::path& path);
+
+	public:
+		static CConfig_Registry& Instance();
+
+		// loads a single catalogue file, or all catalogue files in a directory; a catalogue with any invalid line is rejected as a whole
+		bool Load_Catalogue(const std::string& path);
+
+		// retrieves a copy of the scenario for given config class and config ID; false if there is none
+		bool Find_Scenario(uint32_t config_class, uint32_t config_id, TConfig_Scenario& scenario) const;
+
+		// lists config class and config ID of all scenarios, ordered; a scenario applying to all config IDs of its class is listed with config ID 1
+		std::vector<std::pair<uint32_t, uint32_t>> Get_Scenario_Ids() const;
+
+		// retrieves the template text; loads it from its file on first use; nullptr if the template is not known or could not be loaded
+		const char* Get_Template(const GUID& config_id);
+};
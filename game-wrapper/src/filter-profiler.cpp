@@ -0,0 +1,236 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "filter-profiler.h"
+
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/utils/string_utils.h>
+
+#include <chrono>
+#include <mutex>
+#include <string_view>
+
+namespace
+{
+	std::atomic<bool> gProfiling_Enabled{ false };
+
+	// time spent in probes called (directly or indirectly) by the probe currently executing on this thread
+	thread_local uint64_t tDownstream_Ns = 0;
+
+	const wchar_t* rsProbe_Description = L"Game wrapper profiling probe";
+
+	const scgms::NParameter_Type Probe_Parameter_Types[] = { scgms::NParameter_Type::ptInt64 };
+	const wchar_t* Probe_Parameter_UI_Names[] = { L"Link index" };
+	const wchar_t* Probe_Parameter_Config_Names[] = { rsProbe_Link_Index };
+	const wchar_t* Probe_Parameter_Tooltips[] = { L"Index of the profiled filter in the configuration without probes" };
+
+	const scgms::TFilter_Descriptor Probe_Descriptor = {
+		profiling_probe_id,
+		scgms::NFilter_Flags::None,
+		rsProbe_Description,
+		1,
+		Probe_Parameter_Types,
+		Probe_Parameter_UI_Names,
+		Probe_Parameter_Config_Names,
+		Probe_Parameter_Tooltips
+	};
+
+	HRESULT IfaceCalling Create_Probe(const GUID* id, scgms::IFilter* output, scgms::IFilter** filter)
+	{
+		if (!id || *id != profiling_probe_id)
+			return E_NOTIMPL;
+
+		return Manufacture_Object<CProfiling_Probe>(filter, output);
+	}
+}
+
+CFilter_Profile::CFilter_Profile(const std::string& profiled_contents)
+{
+	constexpr std::string_view filter_tag = "[Filter_";
+
+	// filter sections are named [Filter_<index>_<GUID>]
+	std::vector<GUID> filter_ids;
+	const std::string_view contents{ profiled_contents };
+
+	for (size_t pos = contents.find(filter_tag); pos != std::string_view::npos; pos = contents.find(filter_tag, pos + 1))
+	{
+		const size_t begin = contents.find('{', pos);
+		const size_t end = contents.find('}', pos);
+		const size_t eol = contents.find('\n', pos);
+		if (begin == std::string_view::npos || end == std::string_view::npos || end < begin || (eol != std::string_view::npos && eol < end))
+			continue;
+
+		bool ok = false;
+		const GUID id = WString_To_GUID(Widen_String(std::string{ contents.substr(begin, end - begin + 1) }), ok);
+		if (ok && id != profiling_probe_id)
+			filter_ids.push_back(id);
+	}
+
+	mSlot_Count = filter_ids.size();
+	mSlots = std::make_unique<TSlot[]>(mSlot_Count);
+
+	for (size_t i = 0; i < mSlot_Count; i++)
+		mSlots[i].filter_id = filter_ids[i];
+}
+
+void CFilter_Profile::Record(size_t filter_index, uint64_t ns)
+{
+	if (filter_index >= mSlot_Count)
+		return;
+
+	mSlots[filter_index].event_count.fetch_add(1, std::memory_order_relaxed);
+	mSlots[filter_index].total_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
+std::vector<TFilter_Profile_Entry> CFilter_Profile::Snapshot() const
+{
+	std::vector<TFilter_Profile_Entry> entries(mSlot_Count);
+
+	for (size_t i = 0; i < mSlot_Count; i++)
+	{
+		entries[i].filter_index = static_cast<uint32_t>(i);
+		entries[i].filter_id = mSlots[i].filter_id;
+		entries[i].event_count = mSlots[i].event_count.load(std::memory_order_relaxed);
+		entries[i].total_ns = mSlots[i].total_ns.load(std::memory_order_relaxed);
+	}
+
+	return entries;
+}
+
+CProfiling_Probe::CProfiling_Probe(scgms::IFilter* output) : CBase_Filter(output, profiling_probe_id)
+{
+	//
+}
+
+HRESULT CProfiling_Probe::Do_Configure(scgms::SFilter_Configuration configuration, refcnt::Swstr_list& error_description)
+{
+	const int64_t index = configuration.Read_Int(rsProbe_Link_Index, -1);
+	if (index < 0)
+		return E_INVALIDARG;
+
+	mLink_Index = static_cast<size_t>(index);
+
+	return S_OK;
+}
+
+HRESULT CProfiling_Probe::Do_Execute(scgms::UDevice_Event event)
+{
+	if (!mProfile)
+		return mOutput.Send(event);
+
+	// start a new frame; the downstream time of the enclosing frame is restored (and increased by this frame) once we are done
+	const uint64_t enclosing_downstream_ns = tDownstream_Ns;
+	tDownstream_Ns = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	const HRESULT rc = mOutput.Send(event);
+	const uint64_t elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+	// whatever the next probes did not measure, was spent in the filter right after this probe
+	mProfile->Record(mLink_Index, elapsed_ns > tDownstream_Ns ? elapsed_ns - tDownstream_Ns : 0);
+
+	tDownstream_Ns = enclosing_downstream_ns + elapsed_ns;
+
+	return rc;
+}
+
+void CProfiling_Probe::Attach(const std::shared_ptr<CFilter_Profile>& profile)
+{
+	mProfile = profile;
+}
+
+bool Is_Filter_Profiling_Enabled()
+{
+	return gProfiling_Enabled.load(std::memory_order_acquire);
+}
+
+void Set_Filter_Profiling_Enabled(bool enabled)
+{
+	gProfiling_Enabled.store(enabled, std::memory_order_release);
+}
+
+bool Register_Profiling_Probe()
+{
+	static std::once_flag registered_flag;
+	static bool registered = false;
+
+	std::call_once(registered_flag, []() {
+		registered = scgms::add_filters({ Probe_Descriptor }, &Create_Probe);
+	});
+
+	return registered;
+}
+
+HRESULT IfaceCalling Attach_Profile_On_Filter_Created(scgms::IFilter* filter, const void* data)
+{
+	const auto* profile = static_cast<const std::shared_ptr<CFilter_Profile>*>(data);
+
+	CProfiling_Probe* probe = dynamic_cast<CProfiling_Probe*>(filter);
+	if (probe && profile)
+		probe->Attach(*profile);
+
+	return S_OK;
+}
+
+bool Export_Filter_Profile(const CFilter_Profile* profile, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts, uint64_t* total_ns,
+	uint32_t capacity, uint32_t* count_out)
+{
+	if (!profile)
+		return false;
+
+	const auto entries = profile->Snapshot();
+
+	if (count_out)
+		*count_out = static_cast<uint32_t>(entries.size());
+
+	if (entries.size() > capacity)
+		return false;
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (filter_indices)
+			filter_indices[i] = entries[i].filter_index;
+		if (filter_ids)
+			filter_ids[i] = entries[i].filter_id;
+		if (event_counts)
+			event_counts[i] = entries[i].event_count;
+		if (total_ns)
+			total_ns[i] = entries[i].total_ns;
+	}
+
+	return true;
+}
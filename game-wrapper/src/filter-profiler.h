@@ -0,0 +1,135 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/iface/referencedIface.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Opt-in per-filter profiling of simulation chains
+ * A profiled configuration has a probe filter inserted in front of each configured filter and one at the end of the chain; each probe measures
+ * the time its event spent downstream and subtracts the time measured by the next probe, so that every filter gets just its own time
+ * Time of filters, which pass events to other threads, is attributed to the filter that processes the event synchronously
+ */
+
+constexpr const GUID profiling_probe_id = { 0x3f6a2c1e, 0x8b47, 0x4d2a, { 0x9e, 0x15, 0x6c, 0x02, 0xd4, 0x7b, 0xa3, 0x58 } };	// {3F6A2C1E-8B47-4D2A-9E15-6C02D47BA358}
+
+// configuration name of the probe parameter, that holds the index of the profiled filter
+constexpr const wchar_t* rsProbe_Link_Index = L"Link_Index";
+
+// profile of a single configured filter, as exported through the library interface
+struct TFilter_Profile_Entry
+{
+	uint32_t filter_index;
+	GUID filter_id;
+	uint64_t event_count;
+	uint64_t total_ns;
+};
+
+/*
+ * Accumulated times and event counts of filters of a single chain (or of all chains of an optimization)
+ */
+class CFilter_Profile
+{
+	private:
+		struct TSlot
+		{
+			GUID filter_id = Invalid_GUID;
+			std::atomic<uint64_t> event_count{ 0 };
+			std::atomic<uint64_t> total_ns{ 0 };
+		};
+
+		// slots do not move, as the probes update them concurrently
+		std::unique_ptr<TSlot[]> mSlots;
+		size_t mSlot_Count = 0;
+
+	public:
+		// prepares slots for all filters of given profiled configuration, except the probes
+		CFilter_Profile(const std::string& profiled_contents);
+
+		// adds a single event processed by given filter; ignores indices out of range (i.e.; the terminal probe)
+		void Record(size_t filter_index, uint64_t ns);
+
+		std::vector<TFilter_Profile_Entry> Snapshot() const;
+};
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Probe filter inserted in front of each profiled filter
+ */
+class CProfiling_Probe : public scgms::CBase_Filter
+{
+	private:
+		size_t mLink_Index = 0;
+		std::shared_ptr<CFilter_Profile> mProfile;
+
+	protected:
+		virtual HRESULT Do_Execute(scgms::UDevice_Event event);
+		virtual HRESULT Do_Configure(scgms::SFilter_Configuration configuration, refcnt::Swstr_list& error_description);
+
+	public:
+		CProfiling_Probe(scgms::IFilter* output);
+		virtual ~CProfiling_Probe() = default;
+
+		void Attach(const std::shared_ptr<CFilter_Profile>& profile);
+};
+
+#pragma warning( pop )
+
+// is the profiling enabled for newly created sessions and optimizations?
+bool Is_Filter_Profiling_Enabled();
+void Set_Filter_Profiling_Enabled(bool enabled);
+
+// registers the probe filter to the framework; safe to be called repeatedly
+bool Register_Profiling_Probe();
+
+// on-filter-created callback, that attaches probes to the profile; data is a pointer to std::shared_ptr<CFilter_Profile>
+HRESULT IfaceCalling Attach_Profile_On_Filter_Created(scgms::IFilter* filter, const void* data);
+
+// stores entries of given profile to output arrays (each optional); count_out receives the count of all entries
+bool Export_Filter_Profile(const CFilter_Profile* profile, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts, uint64_t* total_ns,
+	uint32_t capacity, uint32_t* count_out);
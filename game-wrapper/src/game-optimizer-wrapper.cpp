@@ -1,307 +1,875 @@
-/**
- * SmartCGMS - continuous glucose monitoring and controlling framework
- * https://diabetes.zcu.cz/
- *
- * Copyright (c) since 2018 University of West Bohemia.
- *
- * Contact:
- * diabetes@mail.kiv.zcu.cz
- * Medical Informatics, Department of Computer Science and Engineering
- * Faculty of Applied Sciences, University of West Bohemia
- * Univerzitni 8, 301 00 Pilsen
- * Czech Republic
- * 
- * 
- * Purpose of this software:
- * This software is intended to demonstrate work of the diabetes.zcu.cz research
- * group to other scientists, to complement our published papers. It is strictly
- * prohibited to use this software for diagnosis or treatment of any medical condition,
- * without obtaining all required approvals from respective regulatory bodies.
- *
- * Especially, a diabetic patient is warned that unauthorized use of this software
- * may result into severe injure, including death.
- *
- *
- * Licensing terms:
- * Unless required by applicable law or agreed to in writing, software
- * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- *
- * a) This file is available under the Apache License, Version 2.0.
- * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
- *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
- *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
- *    Volume 177, pp. 354-362, 2020
- */
-
-#include "game-optimizer-wrapper.h"
-#include "configs.h"
-#include <scgms/rtl/referencedImpl.h>
-#include <scgms/utils/string_utils.h>
-#include <scgms/rtl/rattime.h>
-
-#include <iostream>
-
-// default solver: Halton MetaDE
-constexpr const GUID Default_Solver_Guid = { 0x1b21b62f, 0x7c6c, 0x4027,{ 0x89, 0xbc, 0x68, 0x7d, 0x8b, 0xd3, 0x2b, 0x3c } };	// {1B21B62F-7C6C-4027-89BC-687D8BD32B3C}
-
-// default generation count; is scaled by degree of optimalization given by outside code
-constexpr const size_t Default_Generation_Count = 10000;
-// default population size; may differ later, when we have more elaborate models
-constexpr const size_t Default_Population_Size = 86;
-
-#undef min
-#undef max
-
-CGame_Optimizer_Wrapper::CGame_Optimizer_Wrapper(uint32_t stepping_ms, uint16_t degree_of_opt)
-	: mStep_Size(scgms::One_Second* (static_cast<double>(stepping_ms) / 1000.0)), mDegree_Of_Optimize(degree_of_opt), mProgress{ solver::Null_Solver_Progress }, mOpt_State(NGame_Optimize_State::None)
-{
-	//
-}
-
-void CGame_Optimizer_Wrapper::Optimizer_Thread_Fnc()
-{
-	scgms::SPersistent_Filter_Chain_Configuration configuration;
-	refcnt::Swstr_list errors;
-
-	mOpt_State = NGame_Optimize_State::Running;
-
-	HRESULT rc = E_FAIL;
-	if (configuration)
-		rc = configuration->Load_From_Memory(mPrepared_Config.c_str(), mPrepared_Config.size(), errors.get());
-
-	if (!Succeeded(rc))
-	{
-		mOpt_State = NGame_Optimize_State::Failed;
-		return;
-	}
-
-	std::wstring optParamName = Widen_String(mOpt_Filter_Parameters_Name);
-
-	// optimize parameters, block this until it's complete
-	const wchar_t* param_to_optimize_name = optParamName.c_str();
-	rc = scgms::Optimize_Parameters(configuration,
-		&mOpt_Filter_Idx, &param_to_optimize_name, 1,
-		nullptr,
-		nullptr,
-		Default_Solver_Guid,
-		Default_Population_Size,
-		Default_Generation_Count * mDegree_Of_Optimize / 100,
-		nullptr,
-		0,
-		mProgress,
-		errors
-	);
-
-	// optimized parameters extracting
-	if (Succeeded(rc))
-	{
-		scgms::IFilter_Configuration_Link** begin, ** end;
-		configuration->get(&begin, &end);
-
-		auto link = begin + mOpt_Filter_Idx;
-
-		scgms::IFilter_Parameter** pbegin, ** pend;
-		(*link)->get(&pbegin, &pend);
-
-		for (; pbegin != pend; pbegin++)
-		{
-			scgms::SFilter_Parameter sparam = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*pbegin, true);
-
-			auto cname = sparam.configuration_name();
-
-			if (std::wstring_view{ cname } == optParamName)
-			{
-				HRESULT hr = S_OK;
-				mOptimized_Parameters = sparam.as_double_array(hr);
-				break;
-			}
-		}
-	}
-
-	if (!Succeeded(rc))
-	{
-		mOpt_State = NGame_Optimize_State::Failed;
-		return;
-	}
-
-	mOpt_State = NGame_Optimize_State::Success;
-}
-
-bool CGame_Optimizer_Wrapper::Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_input_path, const std::string& log_file_output_path)
-{
-	auto cfg_guid = Get_Config_Base_GUID(config_class, config_id);
-	auto params_guid = Get_Config_Parameters_GUID(config_class, config_id);
-
-	mPrepared_Config = Get_Config(cfg_guid, params_guid, mStep_Size, log_file_input_path, log_file_output_path, NConfig_Builder_Purpose::Optimalization,
-		[&](size_t idx, NConfig_Meta meta, const std::string& val) {
-			if (meta == NConfig_Meta::Param_Opt_Filter)
-			{
-				mOpt_Filter_Idx = idx;
-				mOpt_Filter_Parameters_Name = val;
-			}
-		}
-	);
-
-	mPrepared_Config_Replay = Get_Config(cfg_guid, params_guid, mStep_Size, log_file_input_path, log_file_output_path, NConfig_Builder_Purpose::Replay,
-		[&](size_t idx, NConfig_Meta meta, const std::string& val) {
-			if (meta == NConfig_Meta::Param_Opt_Filter)
-				mOpt_Filter_Replay_Idx = idx;
-		}
-	);
-
-	return true;
-}
-
-bool CGame_Optimizer_Wrapper::Start()
-{
-	if (mOpt_Thread)
-		return false;
-
-	mOpt_State = NGame_Optimize_State::Running;
-
-	mProgress.cancelled = FALSE;
-	mProgress.max_progress = 100;
-	mProgress.current_progress = 0;
-	mProgress.best_metric = solver::Nan_Fitness;
-
-	mOpt_Thread = std::make_unique<std::thread>(&CGame_Optimizer_Wrapper::Optimizer_Thread_Fnc, this);
-
-	return true;
-}
-
-NGame_Optimize_State CGame_Optimizer_Wrapper::Get_Progress(double& pct)
-{
-	if (mOpt_State == NGame_Optimize_State::Success)
-		pct = 1.0;
-	else
-		pct = static_cast<double>(mProgress.current_progress) / static_cast<double>(mProgress.max_progress);
-
-	return mOpt_State;
-}
-
-bool CGame_Optimizer_Wrapper::Replay()
-{
-	scgms::SPersistent_Filter_Chain_Configuration configuration;
-	refcnt::Swstr_list errors;
-
-	HRESULT rc = E_FAIL;
-	if (configuration)
-		rc = configuration->Load_From_Memory(mPrepared_Config_Replay.c_str(), mPrepared_Config_Replay.size(), errors.get());
-
-	if (!Succeeded(rc))
-	{
-		mOpt_State = NGame_Optimize_State::Failed;
-		return false;
-	}
-
-	std::wstring optParamName = Widen_String(mOpt_Filter_Parameters_Name);
-
-	// set optimized parameters to filter in replay config
-	{
-		scgms::IFilter_Configuration_Link** begin, **end;
-		configuration->get(&begin, &end);
-
-		auto link = begin + mOpt_Filter_Replay_Idx;
-
-		scgms::IFilter_Parameter** pbegin, ** pend;
-		(*link)->get(&pbegin, &pend);
-
-		for (; pbegin != pend; pbegin++)
-		{
-			scgms::SFilter_Parameter sparam = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*pbegin, true);
-
-			auto cname = sparam.configuration_name();
-
-			if (std::wstring_view{ cname } == optParamName)
-			{
-				sparam.set_double_array(mOptimized_Parameters);
-				break;
-			}
-		}
-	}
-
-	// launch the replay
-	scgms::SFilter_Executor ex{ configuration, nullptr, nullptr, errors };
-
-	if (!ex)
-		return false;
-
-	// wait for shutdown; we just want to store results to log file
-	ex->Terminate(TRUE);
-
-	return true;
-}
-
-bool CGame_Optimizer_Wrapper::Request_Cancel()
-{
-	if (mOpt_State == NGame_Optimize_State::None)
-		return false;
-
-	mProgress.cancelled = TRUE;
-
-	return true;
-}
-
-DLL_EXPORT scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt)
-{
-	std::unique_ptr<CGame_Optimizer_Wrapper> wrapper = std::make_unique<CGame_Optimizer_Wrapper>(stepping_ms, degree_of_opt);
-
-	if (!wrapper->Load_Configuration(config_class, config_id, log_file_input_path, log_file_output_path))
-		return nullptr;
-
-	if (!wrapper->Start())
-		return nullptr;
-
-	auto res = wrapper.get();
-	wrapper.release();
-	return res;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_get_optimize_status(scgms_game_optimizer_wrapper_t wrapper_raw, NGame_Optimize_State * state, double* progress_pct)
-{
-	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	*state = wrapper->Get_Progress(*progress_pct);
-
-	return TRUE;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_cancel_optimize(scgms_game_optimizer_wrapper_t wrapper_raw, BOOL wait)
-{
-	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	if (!wrapper->Request_Cancel())
-		return FALSE;
-
-	if (wait == FALSE)
-		return TRUE;
-
-	NGame_Optimize_State state;
-	double dummy;
-
-	state = wrapper->Get_Progress(dummy);
-	while (state == NGame_Optimize_State::Running)
-	{
-		// this is a kind of an active wait, as it would be implementationally ineffective to implement a conditional variable
-		// the optimizer steals most of the computational resources anyway and is expected to terminate very soon
-		std::this_thread::yield();
-
-		state = wrapper->Get_Progress(dummy);
-	}
-
-	return TRUE;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_optimizer_terminate(scgms_game_optimizer_wrapper_t wrapper_raw)
-{
-	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	return wrapper->Replay() ? TRUE : FALSE;
-}
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "game-optimizer-wrapper.h"
+#include "game-wrapper.h"
+#include "configs.h"
+#include "config-cache.h"
+#include "log-loader.h"
+#include "optimizer-scheduler.h"
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/utils/string_utils.h>
+#include <scgms/rtl/rattime.h>
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+
+// default solver: Halton MetaDE
+constexpr const GUID Default_Solver_Guid = { 0x1b21b62f, 0x7c6c, 0x4027,{ 0x89, 0xbc, 0x68, 0x7d, 0x8b, 0xd3, 0x2b, 0x3c } };	// {1B21B62F-7C6C-4027-89BC-687D8BD32B3C}
+
+// default generation count; is scaled by degree of optimalization given by outside code
+constexpr const size_t Default_Generation_Count = 10000;
+// default population size; may differ later, when we have more elaborate models
+constexpr const size_t Default_Population_Size = 86;
+// maximum count of cached results of previous optimizations used as solver hints
+constexpr const size_t Max_Warm_Start_Hints = 8;
+
+#undef min
+#undef max
+
+CGame_Optimizer_Wrapper::CGame_Optimizer_Wrapper(uint32_t stepping_ms, uint16_t degree_of_opt, uint32_t thread_count)
+	: mStep_Size(scgms::One_Second* (static_cast<double>(stepping_ms) / 1000.0)), mStepping_Ms(stepping_ms), mDegree_Of_Optimize(degree_of_opt), mProgress{ solver::Null_Solver_Progress }, mOpt_State(NGame_Optimize_State::None)
+{
+	mThread_Count = static_cast<size_t>(thread_count);
+}
+
+CGame_Optimizer_Wrapper::~CGame_Optimizer_Wrapper()
+{
+	Request_Cancel();
+	Wait(Infinite_Wait_Timeout);
+}
+
+void CGame_Optimizer_Wrapper::Set_State(NGame_Optimize_State state)
+{
+	// notify under the lock; a waiter may destroy the wrapper as soon as it sees the final state
+	std::lock_guard<std::mutex> lck(mOpt_State_Mtx);
+	mOpt_State = state;
+	mOpt_State_Cv.notify_all();
+}
+
+void CGame_Optimizer_Wrapper::Run_Scheduled()
+{
+	// cancelled after the scheduler has taken it from the queue
+	if (mProgress.cancelled != FALSE)
+	{
+		COptimization_Scheduler::Instance().Release_Running(this);
+		Set_State(NGame_Optimize_State::Failed);
+		return;
+	}
+
+	mRun_Start = std::chrono::steady_clock::now();
+	Set_State(NGame_Optimize_State::Running);
+
+	bool succeeded;
+	{
+		refcnt::Swstr_list errors;
+		succeeded = Optimize_With_Native_Replay(errors);
+	}
+
+	Stop_Eval_Pool();
+
+	COptimization_Scheduler::Instance().Release_Running(this);
+	Set_State(succeeded ? NGame_Optimize_State::Success : NGame_Optimize_State::Failed);
+}
+
+namespace
+{
+	// data passed to filters of an evaluated chain
+	struct TEvaluation_Context
+	{
+		double* metric;
+		const std::shared_ptr<CFilter_Profile>* profile;
+	};
+
+	// asks every filter able to calculate a metric to store it to the context variable, once the filter gets destroyed; attaches profiling probes, if any
+	HRESULT IfaceCalling Promise_Metric_On_Filter_Created(scgms::IFilter* filter, const void* data)
+	{
+		const TEvaluation_Context* context = static_cast<const TEvaluation_Context*>(data);
+		double* metric = context->metric;
+
+		if (*context->profile)
+			Attach_Profile_On_Filter_Created(filter, context->profile);
+
+		scgms::SFilter filter_ref = refcnt::make_shared_reference_ext<scgms::SFilter, scgms::IFilter>(filter, true);
+		scgms::SSignal_Error_Inspection inspection{ filter_ref };
+		if (inspection)
+			return inspection->Promise_Metric(scgms::All_Segments_Id, metric, TRUE);
+
+		return S_OK;
+	}
+}
+
+bool CGame_Optimizer_Wrapper::Feed_Input_Log(scgms::SFilter_Executor& executor, const TOptimized_Log& log)
+{
+	double last_time = 0;
+
+	for (const auto& rec : log.events)
+	{
+		scgms::UDevice_Event evt{ static_cast<scgms::NDevice_Event_Code>(rec.event_code) };
+
+		evt.device_time() = rec.device_time;
+		evt.level() = rec.level;
+		evt.signal_id() = rec.signal_id;
+		evt.device_id() = rec.device_id;
+		evt.segment_id() = rec.segment_id;
+
+		last_time = rec.device_time;
+
+		scgms::IDevice_Event* raw_event = evt.get();
+		evt.release();
+		if (!Succeeded(executor->Execute(raw_event)))
+			return false;
+	}
+
+	scgms::UDevice_Event shut_down{ scgms::NDevice_Event_Code::Shut_Down };
+	shut_down.device_time() = last_time;
+
+	scgms::IDevice_Event* raw_event = shut_down.get();
+	shut_down.release();
+	executor->Execute(raw_event);
+
+	return Succeeded(executor->Terminate(TRUE));
+}
+
+bool CGame_Optimizer_Wrapper::Evaluate(TEvaluation_Worker& worker, const double* solution, const TOptimized_Log& log, double& fitness)
+{
+	fitness = std::numeric_limits<double>::max();
+
+	// the optimized parameter stores lower bounds, values and upper bounds in a row; just the values are being optimized
+	const size_t problem_size = mEval_Bounds.size() / 3;
+
+	worker.parameters = mEval_Bounds;
+	std::copy(solution, solution + problem_size, worker.parameters.begin() + problem_size);
+
+	if (!Succeeded(worker.parameter.set_double_array(worker.parameters)))
+		return false;
+
+	double metric = std::numeric_limits<double>::quiet_NaN();
+
+	{
+		refcnt::Swstr_list errors;
+		const TEvaluation_Context context{ &metric, &mFilter_Profile };
+
+		scgms::SFilter_Executor executor{ worker.configuration, &Promise_Metric_On_Filter_Created, &context, errors };
+		if (!executor)
+			return false;
+
+		if (!Feed_Input_Log(executor, log))
+			return false;
+	}
+
+	// the metric is stored once the chain gets destroyed
+	if (!std::isnan(metric))
+		fitness = metric;
+
+	return true;
+}
+
+TEvaluation_Worker* CGame_Optimizer_Wrapper::Acquire_Eval_Worker()
+{
+	std::unique_lock<std::mutex> lck(mEval_Workers_Mtx);
+
+	mEval_Workers_Cv.wait(lck, [this]() { return !mIdle_Eval_Workers.empty(); });
+
+	TEvaluation_Worker* worker = mIdle_Eval_Workers.back();
+	mIdle_Eval_Workers.pop_back();
+
+	return worker;
+}
+
+void CGame_Optimizer_Wrapper::Release_Eval_Worker(TEvaluation_Worker* worker)
+{
+	{
+		std::lock_guard<std::mutex> lck(mEval_Workers_Mtx);
+		mIdle_Eval_Workers.push_back(worker);
+	}
+
+	mEval_Workers_Cv.notify_one();
+}
+
+void CGame_Optimizer_Wrapper::Start_Eval_Pool(size_t thread_count)
+{
+	mEval_Pool_Stop = false;
+
+	for (size_t i = 0; i < thread_count; i++)
+		mEval_Pool.emplace_back(&CGame_Optimizer_Wrapper::Eval_Pool_Thread_Fnc, this);
+}
+
+void CGame_Optimizer_Wrapper::Stop_Eval_Pool()
+{
+	{
+		std::lock_guard<std::mutex> lck(mEval_Pool_Mtx);
+		mEval_Pool_Stop = true;
+	}
+
+	mEval_Pool_Cv.notify_all();
+
+	for (auto& thread : mEval_Pool)
+		thread.join();
+
+	mEval_Pool.clear();
+}
+
+void CGame_Optimizer_Wrapper::Eval_Pool_Thread_Fnc()
+{
+	std::unique_lock<std::mutex> lck(mEval_Pool_Mtx);
+
+	while (true)
+	{
+		mEval_Pool_Cv.wait(lck, [this]() { return mEval_Pool_Stop || !mEval_Batches.empty(); });
+
+		// the pool is stopped only when no evaluation is in progress
+		if (mEval_Batches.empty())
+			return;
+
+		// the registration keeps the batch alive, until this thread is done with it
+		TEvaluation_Batch* batch = mEval_Batches.front();
+		batch->participants++;
+
+		lck.unlock();
+		Run_Eval_Batch(*batch, true);
+		lck.lock();
+	}
+}
+
+void CGame_Optimizer_Wrapper::Run_Eval_Batch(TEvaluation_Batch& batch, bool participant)
+{
+	const size_t problem_size = mEval_Bounds.size() / 3;
+	const size_t log_count = mInput_Logs.size();
+
+	// every thread leases its own worker, so the solver may also call the objective function concurrently
+	TEvaluation_Worker* worker = nullptr;
+	size_t evaluated = 0;
+
+	for (size_t index = batch.next_index++; index < batch.task_count; index = batch.next_index++)
+	{
+		// lease the worker just once there is something to evaluate
+		if (!worker)
+			worker = Acquire_Eval_Worker();
+
+		// a failed evaluation leaves the worst metric in place, which rejects the solution
+		const size_t solution_index = index / log_count;
+		Evaluate(*worker, batch.solutions + solution_index * problem_size, mInput_Logs[index % log_count], batch.metrics[index]);
+
+		evaluated++;
+	}
+
+	if (worker)
+		Release_Eval_Worker(worker);
+
+	{
+		std::lock_guard<std::mutex> lck(mEval_Pool_Mtx);
+
+		// all tasks are claimed, so there is no point in picking the batch up anymore
+		auto itr = std::find(mEval_Batches.begin(), mEval_Batches.end(), &batch);
+		if (itr != mEval_Batches.end())
+			mEval_Batches.erase(itr);
+
+		batch.completed += evaluated;
+		if (participant)
+			batch.participants--;
+	}
+
+	// the batch may be gone, once the lock is released
+	mEval_Batch_Cv.notify_all();
+}
+
+void CGame_Optimizer_Wrapper::Evaluate_Solutions(size_t solution_count, const double* solutions, double* fitnesses)
+{
+	const size_t log_count = mInput_Logs.size();
+
+	// each (solution, log) pair is a task of its own, so the replays of all logs of a solution run concurrently
+	TEvaluation_Batch batch;
+	batch.solutions = solutions;
+	batch.task_count = solution_count * log_count;
+	batch.metrics.resize(batch.task_count);
+
+	{
+		std::lock_guard<std::mutex> lck(mEval_Pool_Mtx);
+		mEval_Batches.push_back(&batch);
+	}
+
+	mEval_Pool_Cv.notify_all();
+
+	// the calling thread is one of the evaluating threads; then it waits for the tasks claimed by the pool threads
+	Run_Eval_Batch(batch, false);
+
+	{
+		std::unique_lock<std::mutex> lck(mEval_Pool_Mtx);
+		mEval_Batch_Cv.wait(lck, [&batch]() { return batch.completed == batch.task_count && batch.participants == 0; });
+	}
+
+	const std::vector<double>& metrics = batch.metrics;
+
+	for (size_t i = 0; i < solution_count; i++)
+	{
+		const auto first = metrics.begin() + i * log_count;
+		const auto last = first + log_count;
+
+		// a single failed log rejects the solution
+		if (std::find(first, last, std::numeric_limits<double>::max()) != last)
+			fitnesses[i] = std::numeric_limits<double>::max();
+		else
+			fitnesses[i] = std::accumulate(first, last, 0.0) / static_cast<double>(log_count);
+	}
+}
+
+BOOL IfaceCalling CGame_Optimizer_Wrapper::Objective_Fnc(const void* data, const size_t solution_count, const double* solutions, double* const fitnesses)
+{
+	CGame_Optimizer_Wrapper* wrapper = static_cast<CGame_Optimizer_Wrapper*>(const_cast<void*>(data));
+
+	// failed evaluations just penalize their solutions; a single failed chain must not abort the whole optimalization
+	wrapper->Evaluate_Solutions(solution_count, solutions, fitnesses);
+
+	wrapper->Check_Stopping_Criteria();
+
+	return TRUE;
+}
+
+void CGame_Optimizer_Wrapper::Check_Stopping_Criteria()
+{
+	std::lock_guard<std::mutex> lck(mStopping_Mtx);
+
+	if (mStop_Reason != NGame_Optimize_Stop_Reason::None)
+		return;
+
+	// the solver reports the generation as the current progress, and the best metric found so far
+	const double best_metric = mProgress.best_metric[0];
+	const size_t generation = mProgress.current_progress;
+
+	NGame_Optimize_Stop_Reason reason = NGame_Optimize_Stop_Reason::None;
+
+	if (!std::isnan(best_metric))
+	{
+		if (std::isnan(mTracked_Best_Metric) || best_metric < mTracked_Best_Metric - mStopping.min_improvement)
+		{
+			mTracked_Best_Metric = best_metric;
+			mTracked_Best_Generation = generation;
+		}
+
+		if (!std::isnan(mStopping.target_metric) && best_metric <= mStopping.target_metric)
+			reason = NGame_Optimize_Stop_Reason::Target_Reached;
+		else if (mStopping.stall_generations != 0 && generation >= mTracked_Best_Generation + mStopping.stall_generations)
+			reason = NGame_Optimize_Stop_Reason::Converged;
+	}
+
+	if (reason == NGame_Optimize_Stop_Reason::None && mStopping.time_budget_ms != 0
+		&& std::chrono::steady_clock::now() - mRun_Start >= std::chrono::milliseconds(mStopping.time_budget_ms))
+		reason = NGame_Optimize_Stop_Reason::Time_Budget;
+
+	// the solver stops at the closest cancel point and keeps the best solution found so far; a concurrent cancel by outer code takes precedence,
+	// so a cancelled optimalization never gets cached as a converged one
+	NGame_Optimize_Stop_Reason expected = NGame_Optimize_Stop_Reason::None;
+	if (reason != NGame_Optimize_Stop_Reason::None && mStop_Reason.compare_exchange_strong(expected, reason))
+		mProgress.cancelled = TRUE;
+}
+
+bool CGame_Optimizer_Wrapper::Prepare_Eval_Workers(refcnt::Swstr_list& errors)
+{
+	const std::wstring param_name = Widen_String(mOpt_Filter_Parameters_Name);
+
+	mEval_Workers.clear();
+	mIdle_Eval_Workers.clear();
+
+	const size_t thread_count = (mThread_Count != 0) ? mThread_Count : COptimization_Scheduler::Instance().Get_Default_Job_Thread_Count();
+
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		auto worker = std::make_unique<TEvaluation_Worker>();
+
+		if (!worker->configuration || worker->configuration->Load_From_Memory(mPrepared_Config.c_str(), mPrepared_Config.size(), errors.get()) != S_OK)
+			return false;
+
+		worker->parameter = Find_Filter_Parameter(worker->configuration, mOpt_Filter_Idx, param_name);
+		if (!worker->parameter)
+			return false;
+
+		mIdle_Eval_Workers.push_back(worker.get());
+		mEval_Workers.push_back(std::move(worker));
+	}
+
+	return true;
+}
+
+bool CGame_Optimizer_Wrapper::Optimize_With_Native_Replay(refcnt::Swstr_list& errors)
+{
+	if (!Prepare_Eval_Workers(errors))
+		return false;
+
+	// the calling thread evaluates as well, so one pool thread less is needed; the pool is stopped in Run_Scheduled
+	Start_Eval_Pool(mEval_Workers.size() - 1);
+
+	HRESULT rc = S_OK;
+	mEval_Bounds = mEval_Workers.front()->parameter.as_double_array(rc);
+	if (!Succeeded(rc) || mEval_Bounds.empty() || mEval_Bounds.size() % 3 != 0)
+		return false;
+
+	const size_t problem_size = mEval_Bounds.size() / 3;
+	const double* lower_bound = mEval_Bounds.data();
+	const double* default_values = mEval_Bounds.data() + problem_size;
+	const double* upper_bound = mEval_Bounds.data() + 2 * problem_size;
+
+	std::vector<double> solution(default_values, default_values + problem_size);
+
+	// start from the configured values, and from results of previous optimizations of this config and patient
+	std::vector<std::vector<double>> cached_hints;
+	const auto cached_results = mSkip_Cache ? std::vector<TOptimization_Cache_Result>{} : COptimization_Cache::Instance().Find_Similar(mCache_Key, mInput_Log_Hash, Max_Warm_Start_Hints);
+	for (const auto& result : cached_results)
+	{
+		if (result.values.size() != mEval_Bounds.size())
+			continue;
+
+		std::vector<double> hint(result.values.begin() + problem_size, result.values.begin() + 2 * problem_size);
+		for (size_t i = 0; i < problem_size; i++)
+			hint[i] = std::clamp(hint[i], lower_bound[i], upper_bound[i]);
+
+		cached_hints.push_back(std::move(hint));
+	}
+
+	std::vector<const double*> hints{ default_values };
+	for (const auto& hint : cached_hints)
+		hints.push_back(hint.data());
+
+	solver::TSolver_Setup setup{
+		problem_size, 1,
+		lower_bound, upper_bound,
+		hints.data(), hints.size(),
+		solution.data(),
+		this, &CGame_Optimizer_Wrapper::Objective_Fnc,
+		Default_Generation_Count * mDegree_Of_Optimize / 100,
+		Default_Population_Size,
+		0.0
+	};
+
+	if (!Succeeded(solver::Solve_Generic(Default_Solver_Guid, setup, mProgress)))
+		return false;
+
+	mOptimized_Parameters = mEval_Bounds;
+	std::copy(solution.begin(), solution.end(), mOptimized_Parameters.begin() + problem_size);
+
+	// a cancelled or limited optimization did not get as far as requested, so it must not be returned as an exact hit later; a converged one would not get any better
+	const NGame_Optimize_Stop_Reason stop_reason = mStop_Reason;
+	if (stop_reason == NGame_Optimize_Stop_Reason::None || stop_reason == NGame_Optimize_Stop_Reason::Converged)
+	{
+		TOptimization_Cache_Result result;
+		result.log_hash = mInput_Log_Hash;
+		result.config_hash = mConfig_Hash;
+		result.metric = std::isnan(mProgress.best_metric[0]) ? std::numeric_limits<double>::max() : mProgress.best_metric[0];
+		result.degree_of_opt = mDegree_Of_Optimize;
+		result.values = mOptimized_Parameters;
+
+		COptimization_Cache::Instance().Store(mCache_Key, result);
+	}
+
+	return true;
+}
+
+bool CGame_Optimizer_Wrapper::Load_Configuration(uint16_t config_class, uint16_t config_id, const std::vector<std::string>& log_file_input_paths, const std::vector<std::string>& log_file_output_paths)
+{
+	if (log_file_input_paths.empty() || log_file_input_paths.size() != log_file_output_paths.size())
+		return false;
+
+	auto cfg_guid = Get_Config_Base_GUID(config_class, config_id);
+	auto params_guid = Get_Config_Parameters_GUID(config_class, config_id);
+
+	mCache_Key = TOptimization_Cache_Key{ cfg_guid, params_guid, mStepping_Ms };
+
+	mInput_Logs.clear();
+	mInput_Logs.resize(log_file_input_paths.size());
+
+	std::vector<uint64_t> log_hashes;
+
+	for (size_t i = 0; i < mInput_Logs.size(); i++)
+	{
+		TOptimized_Log& log = mInput_Logs[i];
+		log.input_path = log_file_input_paths[i];
+		log.output_path = log_file_output_paths[i];
+
+		// parse the input log just once; all evaluations are fed from memory
+		if (!Load_Log_Events(log.input_path, log.events))
+			return false;
+
+		log_hashes.push_back(Hash_Log_Events(log.events));
+
+		log.replay_config = Get_Config(cfg_guid, params_guid, mStep_Size, log.input_path, log.output_path, NConfig_Builder_Purpose::Replay,
+			[&](size_t idx, NConfig_Meta meta, const std::string& val) {
+				if (meta == NConfig_Meta::Param_Opt_Filter)
+					mOpt_Filter_Replay_Idx = idx;
+			}
+		);
+	}
+
+	mInput_Log_Hash = Combine_Log_Hashes(log_hashes);
+
+	const bool profiled = Is_Filter_Profiling_Enabled() && Register_Profiling_Probe();
+
+	// no input path leaves the log replay filter out of the optimized chain, as the events are fed by Feed_Input_Log
+	mPrepared_Config = Get_Config(cfg_guid, params_guid, mStep_Size, "", mInput_Logs.front().output_path, NConfig_Builder_Purpose::Optimalization,
+		[&](size_t idx, NConfig_Meta meta, const std::string& val) {
+			if (meta == NConfig_Meta::Param_Opt_Filter)
+			{
+				mOpt_Filter_Idx = idx;
+				mOpt_Filter_Parameters_Name = val;
+			}
+		},
+		profiled
+	);
+
+	if (profiled)
+		mFilter_Profile = std::make_shared<CFilter_Profile>(mPrepared_Config);
+
+	// the prepared config names the output log, so the hashed one is built without it; it still changes with the template and the patient parameters
+	mConfig_Hash = Hash_Config(Get_Config(cfg_guid, params_guid, mStep_Size, "", "", NConfig_Builder_Purpose::Optimalization));
+
+	return true;
+}
+
+void CGame_Optimizer_Wrapper::Set_Stopping_Criteria(const TGame_Optimize_Stopping& stopping)
+{
+	mStopping = stopping;
+}
+
+void CGame_Optimizer_Wrapper::Set_Skip_Cache(bool skip_cache)
+{
+	mSkip_Cache = skip_cache;
+}
+
+bool CGame_Optimizer_Wrapper::Start(int32_t priority)
+{
+	if (mOpt_State != NGame_Optimize_State::None)
+		return false;
+
+	mProgress.cancelled = FALSE;
+	mProgress.max_progress = 100;
+	mProgress.current_progress = 0;
+	mProgress.best_metric = solver::Nan_Fitness;
+
+	// the same log has already been optimized at least as thoroughly; no need to run the solver again
+	if (!mSkip_Cache && COptimization_Cache::Instance().Find_Exact(mCache_Key, mInput_Log_Hash, mConfig_Hash, mDegree_Of_Optimize, mOptimized_Parameters))
+	{
+		mProgress.current_progress = mProgress.max_progress;
+		Set_State(NGame_Optimize_State::Success);
+		return true;
+	}
+
+	Set_State(NGame_Optimize_State::Queued);
+	COptimization_Scheduler::Instance().Submit(this, priority);
+
+	return true;
+}
+
+NGame_Optimize_State CGame_Optimizer_Wrapper::Get_Progress(double& pct)
+{
+	if (mOpt_State == NGame_Optimize_State::Success)
+		pct = 1.0;
+	else
+		pct = static_cast<double>(mProgress.current_progress) / static_cast<double>(mProgress.max_progress);
+
+	return mOpt_State;
+}
+
+NGame_Optimize_Stop_Reason CGame_Optimizer_Wrapper::Get_Stop_Reason() const
+{
+	return mStop_Reason;
+}
+
+bool CGame_Optimizer_Wrapper::Replay()
+{
+	bool succeeded = true;
+
+	// replay all logs, even if some of them fail
+	for (const auto& log : mInput_Logs)
+	{
+		if (!Replay_Log(log))
+			succeeded = false;
+	}
+
+	return succeeded;
+}
+
+bool CGame_Optimizer_Wrapper::Replay_Log(const TOptimized_Log& log)
+{
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	refcnt::Swstr_list errors;
+
+	HRESULT rc = E_FAIL;
+	if (configuration)
+		rc = configuration->Load_From_Memory(log.replay_config.c_str(), log.replay_config.size(), errors.get());
+
+	if (!Succeeded(rc))
+	{
+		Set_State(NGame_Optimize_State::Failed);
+		return false;
+	}
+
+	std::wstring optParamName = Widen_String(mOpt_Filter_Parameters_Name);
+
+	// set optimized parameters to filter in replay config
+	scgms::SFilter_Parameter sparam = Find_Filter_Parameter(configuration, mOpt_Filter_Replay_Idx, optParamName);
+	if (sparam)
+		sparam.set_double_array(mOptimized_Parameters);
+
+	// the configs leave the CSV log filter out for binary output logs
+	std::unique_ptr<CBinary_Log_Sink> sink;
+	if (Is_Binary_Log_Path(log.output_path))
+	{
+		sink = std::make_unique<CBinary_Log_Sink>();
+		if (!sink->Open(log.output_path))
+			return false;
+	}
+
+	// launch the replay
+	scgms::SFilter_Executor ex{ configuration, nullptr, nullptr, errors, sink.get() };
+
+	if (!ex)
+		return false;
+
+	// binary input is not read by the chain
+	if (Is_Binary_Log_Path(log.input_path))
+		return Feed_Input_Log(ex, log);
+
+	// wait for shutdown; we just want to store results to log file
+	ex->Terminate(TRUE);
+
+	return true;
+}
+
+bool CGame_Optimizer_Wrapper::Cancel_Scheduled()
+{
+	// an optimalization, that has already ended, keeps its stop reason
+	std::lock_guard<std::mutex> lck(mOpt_State_Mtx);
+
+	if (mOpt_State != NGame_Optimize_State::Queued && mOpt_State != NGame_Optimize_State::Running)
+		return false;
+
+	NGame_Optimize_Stop_Reason expected = NGame_Optimize_Stop_Reason::None;
+	mStop_Reason.compare_exchange_strong(expected, NGame_Optimize_Stop_Reason::Cancelled);
+
+	mProgress.cancelled = TRUE;
+
+	return true;
+}
+
+bool CGame_Optimizer_Wrapper::Request_Cancel()
+{
+	if (mOpt_State == NGame_Optimize_State::None)
+		return false;
+
+	if (!Cancel_Scheduled())
+		return true;
+
+	// a queued optimalization never gets its slot; a running one stops at the closest cancel point
+	if (COptimization_Scheduler::Instance().Remove(this))
+		Set_State(NGame_Optimize_State::Failed);
+
+	return true;
+}
+
+bool CGame_Optimizer_Wrapper::Wait(uint32_t timeout_ms)
+{
+	std::unique_lock<std::mutex> lck(mOpt_State_Mtx);
+
+	auto ended = [this]() { return mOpt_State != NGame_Optimize_State::Running && mOpt_State != NGame_Optimize_State::Queued; };
+
+	if (timeout_ms == Infinite_Wait_Timeout)
+	{
+		mOpt_State_Cv.wait(lck, ended);
+		return true;
+	}
+
+	return mOpt_State_Cv.wait_for(lck, std::chrono::milliseconds(timeout_ms), ended);
+}
+
+const CFilter_Profile* CGame_Optimizer_Wrapper::Get_Filter_Profile() const
+{
+	return mFilter_Profile.get();
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_set_optimization_cache(const char* directory)
+{
+	return COptimization_Cache::Instance().Set_Directory(directory ? directory : "") ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_set_optimization_slots(uint32_t slot_count)
+{
+	COptimization_Scheduler::Instance().Set_Slot_Count(static_cast<size_t>(slot_count));
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_shutdown_optimizations()
+{
+	COptimization_Scheduler::Instance().Shut_Down();
+
+	return TRUE;
+}
+
+DLL_EXPORT scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt)
+{
+	return scgms_game_optimize_ex(config_class, config_id, stepping_ms, log_file_input_path, log_file_output_path, degree_of_opt, 0, FALSE);
+}
+
+DLL_EXPORT scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_ex(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt,
+	uint32_t thread_count, BOOL skip_cache)
+{
+	if (!log_file_input_path || !log_file_output_path)
+		return nullptr;
+
+	return scgms_game_optimize_batch_ex(config_class, config_id, stepping_ms, &log_file_input_path, &log_file_output_path, 1, degree_of_opt, thread_count, nullptr, skip_cache);
+}
+
+DLL_EXPORT scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_batch(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char** log_file_input_paths, const char** log_file_output_paths,
+	uint32_t log_count, uint16_t degree_of_opt, uint32_t thread_count)
+{
+	return scgms_game_optimize_batch_ex(config_class, config_id, stepping_ms, log_file_input_paths, log_file_output_paths, log_count, degree_of_opt, thread_count, nullptr, FALSE);
+}
+
+DLL_EXPORT scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_batch_ex(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char** log_file_input_paths, const char** log_file_output_paths,
+	uint32_t log_count, uint16_t degree_of_opt, uint32_t thread_count, const TGame_Optimize_Stopping* stopping, BOOL skip_cache)
+{
+	if (!log_file_input_paths || !log_file_output_paths || log_count == 0)
+		return nullptr;
+
+	std::vector<std::string> input_paths, output_paths;
+	for (uint32_t i = 0; i < log_count; i++)
+	{
+		if (!log_file_input_paths[i] || !log_file_output_paths[i])
+			return nullptr;
+
+		input_paths.push_back(log_file_input_paths[i]);
+		output_paths.push_back(log_file_output_paths[i]);
+	}
+
+	std::unique_ptr<CGame_Optimizer_Wrapper> wrapper = std::make_unique<CGame_Optimizer_Wrapper>(stepping_ms, degree_of_opt, thread_count);
+
+	if (!wrapper->Load_Configuration(config_class, config_id, input_paths, output_paths))
+		return nullptr;
+
+	if (stopping)
+		wrapper->Set_Stopping_Criteria(*stopping);
+
+	wrapper->Set_Skip_Cache(skip_cache != FALSE);
+
+	if (!wrapper->Start())
+		return nullptr;
+
+	auto res = wrapper.get();
+	wrapper.release();
+	return res;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_set_optimize_priority(scgms_game_optimizer_wrapper_t wrapper_raw, int32_t priority)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return COptimization_Scheduler::Instance().Set_Priority(wrapper, priority) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_optimize_status(scgms_game_optimizer_wrapper_t wrapper_raw, NGame_Optimize_State * state, double* progress_pct)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	*state = wrapper->Get_Progress(*progress_pct);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_optimize_stop_reason(scgms_game_optimizer_wrapper_t wrapper_raw, NGame_Optimize_Stop_Reason* reason)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper || !reason)
+		return FALSE;
+
+	*reason = wrapper->Get_Stop_Reason();
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_cancel_optimize(scgms_game_optimizer_wrapper_t wrapper_raw, BOOL wait)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	if (!wrapper->Request_Cancel())
+		return FALSE;
+
+	if (wait == FALSE)
+		return TRUE;
+
+	wrapper->Wait(Infinite_Wait_Timeout);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_wait_optimize(scgms_game_optimizer_wrapper_t wrapper_raw, uint32_t timeout_ms)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	double dummy;
+	if (wrapper->Get_Progress(dummy) == NGame_Optimize_State::None)
+		return FALSE;
+
+	return wrapper->Wait(timeout_ms) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_optimizer_get_filter_profile(scgms_game_optimizer_wrapper_t wrapper_raw, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts,
+	uint64_t* total_ns, uint32_t capacity, uint32_t* count_out)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return Export_Filter_Profile(wrapper->Get_Filter_Profile(), filter_indices, filter_ids, event_counts, total_ns, capacity, count_out) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_optimizer_terminate(scgms_game_optimizer_wrapper_t wrapper_raw)
+{
+	CGame_Optimizer_Wrapper* wrapper = dynamic_cast<CGame_Optimizer_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return wrapper->Replay() ? TRUE : FALSE;
+}
@@ -1,195 +1,554 @@
-/**
- * SmartCGMS - continuous glucose monitoring and controlling framework
- * https://diabetes.zcu.cz/
- *
- * Copyright (c) since 2018 University of West Bohemia.
- *
- * Contact:
- * diabetes@mail.kiv.zcu.cz
- * Medical Informatics, Department of Computer Science and Engineering
- * Faculty of Applied Sciences, University of West Bohemia
- * Univerzitni 8, 301 00 Pilsen
- * Czech Republic
- * 
- * 
- * Purpose of this software:
- * This software is intended to demonstrate work of the diabetes.zcu.cz research
- * group to other scientists, to complement our published papers. It is strictly
- * prohibited to use this software for diagnosis or treatment of any medical condition,
- * without obtaining all required approvals from respective regulatory bodies.
- *
- * Especially, a diabetic patient is warned that unauthorized use of this software
- * may result into severe injure, including death.
- *
- *
- * Licensing terms:
- * Unless required by applicable law or agreed to in writing, software
- * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- *
- * a) This file is available under the Apache License, Version 2.0.
- * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
- *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
- *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
- *    Volume 177, pp. 354-362, 2020
- */
-
-#pragma once
-
-#include <scgms/iface/FilterIface.h>
-#include <scgms/rtl/FilterLib.h>
-#include <scgms/rtl/scgmsLib.h>
-#include <scgms/iface/referencedIface.h>
-#include <scgms/iface/SolverIface.h>
-#include <scgms/rtl/UILib.h>
-#include <scgms/rtl/SolverLib.h>
-
-#include <cstdint>
-#include <cmath>
-#include <limits>
-#include <mutex>
-#include <thread>
-
-// enumeration of optimalization states
-enum class NGame_Optimize_State : size_t
-{
-	None		= 0,	// optimalization hasn't started yet; this should never be exported through library interface, as this state gets immediatelly replaced by either Running of Failed state
-	Running		= 1,	// in progress
-	Success		= 2,	// finished successfully
-	Failed		= 3,	// failed, unable to find parameters
-
-	count
-};
-
-#pragma warning( push )
-#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
-
-/*
- * Game optimizer wrapper to split back-end logic (how to properly handle optimalization) from front-end
- */
-class CGame_Optimizer_Wrapper : public refcnt::CNotReferenced
-{
-	private:
-		// default step size, should be the same as in the original game run
-		double mStep_Size = 0;
-
-		// 0 - 100 (in percents of recommended pop size / generation count
-		uint16_t mDegree_Of_Optimize = 20;
-
-		// config prepared for optimalization
-		std::string mPrepared_Config;
-		// config prepared for optimalization replay (should log the outputs)
-		std::string mPrepared_Config_Replay;
-
-		// vector of optimized parameters
-		std::vector<double> mOptimized_Parameters;
-
-		// thread for optimalization
-		std::unique_ptr<std::thread> mOpt_Thread;
-
-		// stored solver progress
-		solver::TSolver_Progress mProgress;
-
-		// optimalization progress state
-		NGame_Optimize_State mOpt_State;
-
-		// identifier of optimized index in optimalization config
-		size_t mOpt_Filter_Idx = 0;
-		// identifier of optimized index in replay config
-		size_t mOpt_Filter_Replay_Idx = 0;
-		// name of parameter set in configuration
-		std::string mOpt_Filter_Parameters_Name = "";
-
-	protected:
-		// thread for optimizer
-		void Optimizer_Thread_Fnc();
-
-	public:
-		CGame_Optimizer_Wrapper(uint32_t stepping_ms, uint16_t degree_of_opt);
-
-		// loads configuration based on given parameters - loads game log from input path, stores optimized gameplay to output path
-		bool Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_input_path, const std::string& log_file_output_path);
-
-		// starts the optimalization
-		bool Start();
-
-		// retrieves progress from internal container
-		NGame_Optimize_State Get_Progress(double& pct);
-
-		// replays the optimized config; this assumes the optimalization process was successfull
-		bool Replay();
-
-		// cancels the optimalization at the closest cancel point
-		bool Request_Cancel();
-};
-
-#pragma warning( pop )
-
-// a type for interop-exportable pointer to CGame_Optimizer_Wrapper instance; the pointer should never be dereferenced in outer code as the CGame_Wrapper class is not designed to be interoperable
-using scgms_game_optimizer_wrapper_t = CGame_Optimizer_Wrapper*;
-
-/*
- * scgms_game_optimize
- *
- * Optimizes the parameters of given configuration based on given logfile
- *
- * Parameters:
- *		config_class - class of config to be used for optimalization
- *		config_id - identifier of config within given class
- *		stepping_ms - stepping of whole model in milliseconds
- *		log_file_input_path - path to input log (to be replayed in order to optimize)
- *		log_file_output_path - path to output (where the optimized gameplay should be stored)
- *		degree_of_opt - degree of optimalization (generations count); the higher value, the longer it takes, but the better the result should be
- *
- * Return values:
- *		<a valid scgms_game_optimizer_wrapper_t pointer> - success
- *		nullptr - failure
- */
-extern "C" scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms,
-	const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt);
-
-/*
- * scgms_game_get_optimize_status
- *
- * Retrieves the current state of running optimalization
- *
- * Parameters:
- *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
- *		state - output variable for current optimizer state enum value
- *		progress_pct - output variable for current progress (0 - 1)
- *
- * Return values:
- *		TRUE (non-zero) - success, state retrieved successfully
- *		FALSE (zero) - failure
- */
-extern "C" BOOL IfaceCalling scgms_game_get_optimize_status(scgms_game_optimizer_wrapper_t wrapper, NGame_Optimize_State* state, double* progress_pct);
-
-/*
- * scgms_game_cancel_optimize
- * 
- * Cancels the optimalization at the closest cancel point (e.g.; in between generations of a genetic algorithm, ...)
- * Optionally waits for the optimalization to be cancelled before returning to caller.
- * 
- * Parameters:
- *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
- *		wait - TRUE (non-zero) waits for optimalization to be terminated, FALSE (zero) requests the termination and returns immediatelly
- * 
- * Return values:
- *		TRUE (non-zero) - success, termination has been requested (if wait is TRUE, the optimalization has also ended)
- *		FALSE (zero) - no optimalization is running
- */
-extern "C" BOOL IfaceCalling scgms_game_cancel_optimize(scgms_game_optimizer_wrapper_t wrapper, BOOL wait);
-
-/*
- * scgms_game_optimizer_terminate
- *
- * Terminates the optimalization; replays the optimized state and stores outputs to the log file given in initial optimize call
- *
- * Parameters:
- *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
- *
- * Return values:
- *		TRUE (non-zero) - success, optimalization successfully terminated and log file stored
- *		FALSE (zero) - failure
- */
-extern "C" BOOL IfaceCalling scgms_game_optimizer_terminate(scgms_game_optimizer_wrapper_t wrapper);
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/scgmsLib.h>
+#include <scgms/iface/referencedIface.h>
+#include <scgms/iface/SolverIface.h>
+#include <scgms/rtl/UILib.h>
+#include <scgms/rtl/SolverLib.h>
+
+#include "binary-log.h"
+#include "filter-profiler.h"
+#include "optimizer-cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// enumeration of optimalization states
+enum class NGame_Optimize_State : size_t
+{
+	None		= 0,	// optimalization hasn't started yet; this should never be exported through library interface, as this state gets immediatelly replaced by either Running of Failed state
+	Running		= 1,	// in progress
+	Success		= 2,	// finished successfully
+	Failed		= 3,	// failed, unable to find parameters
+	Queued		= 4,	// waiting for a free slot of the optimalization scheduler
+
+	count
+};
+
+// chain instance owned by a single evaluation worker of the native replay
+struct TEvaluation_Worker
+{
+	// configuration loaded from the prepared optimization config; the optimized parameter is set before each evaluation
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	scgms::SFilter_Parameter parameter;
+	// scratch buffer for bounds and values of the evaluated candidate
+	std::vector<double> parameters;
+};
+
+// reasons of optimalization ending before all generations are evaluated
+enum class NGame_Optimize_Stop_Reason : size_t
+{
+	None			= 0,	// not stopped (yet), or all generations have been evaluated
+	Cancelled		= 1,	// cancelled by outer code
+	Converged		= 2,	// the best metric stopped improving
+	Target_Reached	= 3,	// the best metric reached the target value
+	Time_Budget		= 4,	// the time budget has been spent
+
+	count
+};
+
+// criteria stopping the optimalization before all generations are evaluated; passed to scgms_game_optimize_batch_ex
+struct TGame_Optimize_Stopping
+{
+	// stops once the best metric has not improved by more than min_improvement over stall_generations generations
+	double min_improvement;
+	// stops once the best metric is lower or equal to target_metric; NaN disables the criterion
+	double target_metric;
+	// zero disables the min_improvement criterion
+	uint32_t stall_generations;
+	// stops once the optimalization has been running for time_budget_ms milliseconds, not counting the time spent in the queue; zero disables the criterion
+	uint32_t time_budget_ms;
+};
+
+static_assert(sizeof(TGame_Optimize_Stopping) == 24, "Optimize stopping criteria must be 24 bytes long");
+
+// a single input log of the optimalization
+struct TOptimized_Log
+{
+	std::string input_path;
+	// where the replay with optimized parameters is stored
+	std::string output_path;
+	// config replaying the log with optimized parameters (should log the outputs)
+	std::string replay_config;
+	// events of the log, parsed just once; the log is fed from memory to every evaluated chain, so there is no file I/O in the optimization loop
+	// never modified once loaded, so the evaluation workers share it without locking
+	std::vector<TBinary_Log_Record> events;
+};
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Game optimizer wrapper to split back-end logic (how to properly handle optimalization) from front-end
+ */
+class CGame_Optimizer_Wrapper : public refcnt::CNotReferenced
+{
+	private:
+		// default step size, should be the same as in the original game run
+		double mStep_Size = 0;
+		uint32_t mStepping_Ms = 0;
+
+		// 0 - 100 (in percents of recommended pop size / generation count
+		uint16_t mDegree_Of_Optimize = 20;
+
+		// count of threads evaluating candidate solutions of the native replay; zero leaves the choice to the scheduler
+		size_t mThread_Count = 0;
+
+		// config prepared for optimalization
+		std::string mPrepared_Config;
+
+		// vector of optimized parameters
+		std::vector<double> mOptimized_Parameters;
+
+		// stored solver progress
+		solver::TSolver_Progress mProgress;
+
+		// stopping criteria; all disabled by default
+		TGame_Optimize_Stopping mStopping{ 0.0, std::numeric_limits<double>::quiet_NaN(), 0, 0 };
+		// guards tracking of the best metric, as the objective function may be called concurrently
+		std::mutex mStopping_Mtx;
+		// best metric, that was an improvement by more than min_improvement, and the generation it was reached in
+		double mTracked_Best_Metric = std::numeric_limits<double>::quiet_NaN();
+		size_t mTracked_Best_Generation = 0;
+		// when the optimalization got its scheduler slot
+		std::chrono::steady_clock::time_point mRun_Start;
+		std::atomic<NGame_Optimize_Stop_Reason> mStop_Reason{ NGame_Optimize_Stop_Reason::None };
+
+		// optimalization progress state; changes are signalled through mOpt_State_Cv
+		std::atomic<NGame_Optimize_State> mOpt_State;
+		std::mutex mOpt_State_Mtx;
+		std::condition_variable mOpt_State_Cv;
+
+		// identifier of optimized index in optimalization config
+		size_t mOpt_Filter_Idx = 0;
+		// identifier of optimized index in replay config
+		size_t mOpt_Filter_Replay_Idx = 0;
+		// name of parameter set in configuration
+		std::string mOpt_Filter_Parameters_Name = "";
+
+		// input logs; the parameters are fitted to all of them at once
+		std::vector<TOptimized_Log> mInput_Logs;
+		// hash of events of all input logs; identifies the logs in the optimization cache
+		uint64_t mInput_Log_Hash = 0;
+
+		// group of results in the optimization cache, this optimization belongs to
+		TOptimization_Cache_Key mCache_Key{};
+		// hash of the expanded config; a cached result of another config is used just as a hint
+		uint64_t mConfig_Hash = 0;
+		// ignore cached results; the new result still replaces the cached one
+		bool mSkip_Cache = false;
+
+		// evaluation workers of the native replay, each with its own chain configuration; one per thread
+		std::vector<std::unique_ptr<TEvaluation_Worker>> mEval_Workers;
+		// workers not leased by any evaluating thread
+		std::vector<TEvaluation_Worker*> mIdle_Eval_Workers;
+		std::mutex mEval_Workers_Mtx;
+		std::condition_variable mEval_Workers_Cv;
+		// lower bounds, default values and upper bounds of the optimized parameters, as stored in the configuration
+		std::vector<double> mEval_Bounds;
+
+		// (solution, log) evaluation tasks of a single objective function call; shared by the calling thread and the evaluation pool
+		struct TEvaluation_Batch
+		{
+			const double* solutions = nullptr;
+			size_t task_count = 0;
+			std::vector<double> metrics;
+			std::atomic<size_t> next_index{ 0 };
+			// guarded by mEval_Pool_Mtx
+			size_t completed = 0;
+			size_t participants = 0;
+		};
+		// threads helping objective function calls with evaluations; they live for the whole optimalization run, alongside the workers
+		std::vector<std::thread> mEval_Pool;
+		// batches, that may still have unclaimed tasks
+		std::deque<TEvaluation_Batch*> mEval_Batches;
+		bool mEval_Pool_Stop = false;
+		std::mutex mEval_Pool_Mtx;
+		// wakes up the pool threads, when a batch is queued or the pool is stopped
+		std::condition_variable mEval_Pool_Cv;
+		// signals completed tasks to the objective function calls waiting for their batches
+		std::condition_variable mEval_Batch_Cv;
+
+		// per-filter profile of all evaluated chains; just for optimizations started while the profiling was enabled
+		std::shared_ptr<CFilter_Profile> mFilter_Profile;
+
+	protected:
+		// stores the optimalization state and wakes up all waiting threads
+		void Set_State(NGame_Optimize_State state);
+
+		// optimizes parameters by replaying the preloaded input log to the chain, instead of letting the chain read it
+		bool Optimize_With_Native_Replay(refcnt::Swstr_list& errors);
+		// prepares one evaluation worker per thread
+		bool Prepare_Eval_Workers(refcnt::Swstr_list& errors);
+		// leases an idle evaluation worker; blocks until some worker is available
+		TEvaluation_Worker* Acquire_Eval_Worker();
+		// returns the worker leased by Acquire_Eval_Worker
+		void Release_Eval_Worker(TEvaluation_Worker* worker);
+		// starts given count of evaluation pool threads
+		void Start_Eval_Pool(size_t thread_count);
+		// stops and joins the evaluation pool threads; there must be no evaluation in progress
+		void Stop_Eval_Pool();
+		// evaluation pool thread function; helps with queued batches until the pool is stopped
+		void Eval_Pool_Thread_Fnc();
+		// evaluates tasks of given batch until all of them are claimed; participant tells, that the calling thread is registered in the batch
+		void Run_Eval_Batch(TEvaluation_Batch& batch, bool participant);
+		// evaluates given candidate solutions in parallel, each on all input logs; the fitness is the mean metric over the logs
+		// a solution, that fails to evaluate on any log, gets the worst fitness, so the solver just discards it and goes on
+		void Evaluate_Solutions(size_t solution_count, const double* solutions, double* fitnesses);
+		// replays given log to the optimization chain of given worker with given candidate solution and retrieves its metric
+		bool Evaluate(TEvaluation_Worker& worker, const double* solution, const TOptimized_Log& log, double& fitness);
+		// passes all preloaded events of given input log to given chain and shuts the chain down
+		bool Feed_Input_Log(scgms::SFilter_Executor& executor, const TOptimized_Log& log);
+		// replays given input log with optimized parameters and stores outputs to its output log
+		bool Replay_Log(const TOptimized_Log& log);
+
+		// evaluates stopping criteria against the solver progress; requests the solver to stop, if any of them is met
+		void Check_Stopping_Criteria();
+
+		// solver objective function
+		static BOOL IfaceCalling Objective_Fnc(const void* data, const size_t solution_count, const double* solutions, double* const fitnesses);
+
+	public:
+		// thread_count of zero shares the hardware threads with other optimalizations running at once
+		CGame_Optimizer_Wrapper(uint32_t stepping_ms, uint16_t degree_of_opt, uint32_t thread_count = 0);
+		// cancels the queued or running optimalization and waits for it to end
+		virtual ~CGame_Optimizer_Wrapper();
+
+		// loads configuration based on given parameters - loads game logs from input paths, stores optimized gameplays to output paths (one per input log)
+		bool Load_Configuration(uint16_t config_class, uint16_t config_id, const std::vector<std::string>& log_file_input_paths, const std::vector<std::string>& log_file_output_paths);
+
+		// sets criteria to stop the optimalization early; must be called before the optimalization starts
+		void Set_Stopping_Criteria(const TGame_Optimize_Stopping& stopping);
+		// makes the optimalization ignore cached results; must be called before the optimalization starts
+		void Set_Skip_Cache(bool skip_cache);
+
+		// starts the optimalization; the optimalization is queued until the scheduler has a free slot
+		bool Start(int32_t priority = 0);
+		// runs the optimalization on the calling thread; called by the scheduler, once the optimalization gets its slot
+		void Run_Scheduled();
+
+		// retrieves progress from internal container
+		NGame_Optimize_State Get_Progress(double& pct);
+		// retrieves why the optimalization stopped before evaluating all generations
+		NGame_Optimize_Stop_Reason Get_Stop_Reason() const;
+
+		// replays the optimized config; this assumes the optimalization process was successfull
+		bool Replay();
+
+		// cancels the optimalization at the closest cancel point
+		bool Request_Cancel();
+		// marks a queued or running optimalization cancelled, without removing it from the scheduler queue; returns false if it is neither queued nor running
+		bool Cancel_Scheduled();
+
+		// waits until the optimalization ends, at most timeout_ms milliseconds
+		// returns true if the optimalization is neither queued nor running
+		bool Wait(uint32_t timeout_ms);
+
+		// retrieves per-filter profile; nullptr if the optimalization is not profiled
+		const CFilter_Profile* Get_Filter_Profile() const;
+};
+
+#pragma warning( pop )
+
+// a type for interop-exportable pointer to CGame_Optimizer_Wrapper instance; the pointer should never be dereferenced in outer code as the CGame_Wrapper class is not designed to be interoperable
+using scgms_game_optimizer_wrapper_t = CGame_Optimizer_Wrapper*;
+
+/*
+ * scgms_game_set_optimization_cache
+ *
+ * Sets directory of the persistent optimization cache; the cache is disabled until this is called
+ * Optimizing a log, that has already been optimized with the same config, patient and stepping, returns the stored result immediately;
+ * results of other logs seed the solver as hints
+ * Results are tagged with a hash of the expanded config, so they are not returned as exact hits once the config template or the patient database changes
+ *
+ * Parameters:
+ *		directory - path to the cache directory, created if it does not exist; nullptr or an empty string disables the cache
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure, the directory cannot be created
+ */
+extern "C" BOOL IfaceCalling scgms_game_set_optimization_cache(const char* directory);
+
+/*
+ * scgms_game_set_optimization_slots
+ *
+ * Sets count of optimalizations, that may run at once; further optimalizations are queued (in the Queued state) until a slot gets free
+ *
+ * Parameters:
+ *		slot_count - count of slots; zero restores the default
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_set_optimization_slots(uint32_t slot_count);
+
+/*
+ * scgms_game_shutdown_optimizations
+ *
+ * Waits until all scheduled optimalizations end and joins the scheduler threads, that run them
+ * The scheduler threads execute library code until they are joined, so this must be called before the library is unloaded (e.g.; with FreeLibrary
+ * or dlclose), after all optimizer wrappers are terminated; unloading a library with a scheduler thread still running may crash or deadlock the process
+ * Optimalizations may be started again afterwards
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_shutdown_optimizations();
+
+/*
+ * scgms_game_optimize
+ *
+ * Optimizes the parameters of given configuration based on given logfile
+ *
+ * Parameters:
+ *		config_class - class of config to be used for optimalization
+ *		config_id - identifier of config within given class
+ *		stepping_ms - stepping of whole model in milliseconds
+ *		log_file_input_path - path to input log (to be replayed in order to optimize); either CSV, or binary (.sbl)
+ *		log_file_output_path - path to output (where the optimized gameplay should be stored); the .sbl extension selects the binary format
+ *		degree_of_opt - degree of optimalization (generations count); the higher value, the longer it takes, but the better the result should be
+ *
+ * Return values:
+ *		<a valid scgms_game_optimizer_wrapper_t pointer> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms,
+	const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt);
+
+/*
+ * scgms_game_optimize_ex
+ *
+ * Optimizes the parameters of given configuration based on given logfile, evaluating the candidate solutions on given count of threads
+ * Each thread replays its own chain instance
+ *
+ * Parameters:
+ *		config_class - class of config to be used for optimalization
+ *		config_id - identifier of config within given class
+ *		stepping_ms - stepping of whole model in milliseconds
+ *		log_file_input_path - path to input log (to be replayed in order to optimize); either CSV, or binary (.sbl)
+ *		log_file_output_path - path to output (where the optimized gameplay should be stored); the .sbl extension selects the binary format
+ *		degree_of_opt - degree of optimalization (generations count); the higher value, the longer it takes, but the better the result should be
+ *		thread_count - count of evaluating threads; zero shares the hardware threads with other optimalizations running at once
+ *		skip_cache - TRUE (non-zero) ignores the optimization cache (neither returns a stored result, nor uses stored results as hints); the new result still replaces the stored one
+ *
+ * Return values:
+ *		<a valid scgms_game_optimizer_wrapper_t pointer> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_ex(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms,
+	const char* log_file_input_path, const char* log_file_output_path, uint16_t degree_of_opt, uint32_t thread_count, BOOL skip_cache);
+
+/*
+ * scgms_game_optimize_batch
+ *
+ * Optimizes the parameters of given configuration to fit all given logfiles at once (e.g.; a history of sessions of the same player)
+ * The fitness is the mean metric over all logs; replays of all logs are evaluated concurrently on given count of threads
+ * On termination, each log is replayed with the optimized parameters to its output path
+ *
+ * Parameters:
+ *		config_class - class of config to be used for optimalization
+ *		config_id - identifier of config within given class
+ *		stepping_ms - stepping of whole model in milliseconds
+ *		log_file_input_paths - array of paths to input logs; either CSV, or binary (.sbl)
+ *		log_file_output_paths - array of paths to outputs, one per input log; the .sbl extension selects the binary format
+ *		log_count - count of input (and output) logs
+ *		degree_of_opt - degree of optimalization (generations count); the higher value, the longer it takes, but the better the result should be
+ *		thread_count - count of evaluating threads; zero shares the hardware threads with other optimalizations running at once
+ *
+ * Return values:
+ *		<a valid scgms_game_optimizer_wrapper_t pointer> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_batch(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms,
+	const char** log_file_input_paths, const char** log_file_output_paths, uint32_t log_count, uint16_t degree_of_opt, uint32_t thread_count);
+
+/*
+ * scgms_game_optimize_batch_ex
+ *
+ * The same as scgms_game_optimize_batch, but stops the optimalization as soon as any of given criteria is met
+ * The optimalization then ends in the Success state with the best parameters found so far; scgms_game_get_optimize_stop_reason tells, which criterion stopped it
+ * Converged optimalizations are stored to the optimization cache, as they would not get any better; time-limited and target-limited ones are not
+ *
+ * Parameters:
+ *		config_class - class of config to be used for optimalization
+ *		config_id - identifier of config within given class
+ *		stepping_ms - stepping of whole model in milliseconds
+ *		log_file_input_paths - array of paths to input logs; either CSV, or binary (.sbl)
+ *		log_file_output_paths - array of paths to outputs, one per input log; the .sbl extension selects the binary format
+ *		log_count - count of input (and output) logs
+ *		degree_of_opt - degree of optimalization (maximum generations count)
+ *		thread_count - count of evaluating threads; zero shares the hardware threads with other optimalizations running at once
+ *		stopping - stopping criteria; nullptr runs all generations given by degree_of_opt
+ *		skip_cache - TRUE (non-zero) ignores the optimization cache, like in scgms_game_optimize_ex
+ *
+ * Return values:
+ *		<a valid scgms_game_optimizer_wrapper_t pointer> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_optimizer_wrapper_t IfaceCalling scgms_game_optimize_batch_ex(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms,
+	const char** log_file_input_paths, const char** log_file_output_paths, uint32_t log_count, uint16_t degree_of_opt, uint32_t thread_count, const TGame_Optimize_Stopping* stopping, BOOL skip_cache);
+
+/*
+ * scgms_game_set_optimize_priority
+ *
+ * Changes priority of a queued optimalization; optimalizations of higher priority get a free slot first, optimalizations of the same priority in the order of creation
+ * All optimalizations are queued with priority 0
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *		priority - new priority
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, the priority has been changed
+ *		FALSE (zero) - failure, the optimalization is not queued (anymore)
+ */
+extern "C" BOOL IfaceCalling scgms_game_set_optimize_priority(scgms_game_optimizer_wrapper_t wrapper, int32_t priority);
+
+/*
+ * scgms_game_get_optimize_status
+ *
+ * Retrieves the current state of running optimalization
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *		state - output variable for current optimizer state enum value
+ *		progress_pct - output variable for current progress (0 - 1)
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, state retrieved successfully
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_optimize_status(scgms_game_optimizer_wrapper_t wrapper, NGame_Optimize_State* state, double* progress_pct);
+
+/*
+ * scgms_game_get_optimize_stop_reason
+ *
+ * Retrieves the reason of the optimalization ending before all generations have been evaluated
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *		reason - output variable for the stop reason enum value; None, if the optimalization has not been stopped (yet)
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, reason retrieved successfully
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_optimize_stop_reason(scgms_game_optimizer_wrapper_t wrapper, NGame_Optimize_Stop_Reason* reason);
+
+/*
+ * scgms_game_cancel_optimize
+ * 
+ * Cancels the optimalization at the closest cancel point (e.g.; in between generations of a genetic algorithm, ...)
+ * Optionally waits for the optimalization to be cancelled before returning to caller.
+ * 
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *		wait - TRUE (non-zero) waits for optimalization to be terminated, FALSE (zero) requests the termination and returns immediatelly
+ * 
+ * Return values:
+ *		TRUE (non-zero) - success, termination has been requested (if wait is TRUE, the optimalization has also ended)
+ *		FALSE (zero) - no optimalization is running
+ */
+extern "C" BOOL IfaceCalling scgms_game_cancel_optimize(scgms_game_optimizer_wrapper_t wrapper, BOOL wait);
+
+/*
+ * scgms_game_wait_optimize
+ *
+ * Waits until the optimalization ends (either successfully, by failure, or by cancellation), without polling the state
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *		timeout_ms - maximum time to wait in milliseconds; Infinite_Wait_Timeout (UINT32_MAX) to wait until the optimalization ends
+ *
+ * Return values:
+ *		TRUE (non-zero) - the optimalization has ended; scgms_game_get_optimize_status retrieves the final state
+ *		FALSE (zero) - failure, the timeout elapsed or no optimalization was started
+ */
+extern "C" BOOL IfaceCalling scgms_game_wait_optimize(scgms_game_optimizer_wrapper_t wrapper, uint32_t timeout_ms);
+
+/*
+ * scgms_game_optimizer_get_filter_profile
+ *
+ * Retrieves cumulative time and event count of each filter of the optimized chain, summed over all evaluated candidate solutions
+ * Each output array is optional (may be nullptr); see scgms_game_get_filter_profile for the meaning of outputs
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call, while the profiling was enabled
+ *		filter_indices - output array of filter indices within the configuration (without probes)
+ *		filter_ids - output array of filter GUIDs
+ *		event_counts - output array of counts of events, that entered the filter
+ *		total_ns - output array of time spent in the filter itself in nanoseconds
+ *		capacity - capacity of output arrays
+ *		count_out - pointer to a memory, where the count of profiled filters is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, all filters have been stored
+ *		FALSE (zero) - failure, the optimalization is not profiled, or the output arrays are too small (count_out then holds the required capacity)
+ */
+extern "C" BOOL IfaceCalling scgms_game_optimizer_get_filter_profile(scgms_game_optimizer_wrapper_t wrapper, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts,
+	uint64_t* total_ns, uint32_t capacity, uint32_t* count_out);
+
+/*
+ * scgms_game_optimizer_terminate
+ *
+ * Terminates the optimalization; replays the optimized state and stores outputs to the log file given in initial optimize call
+ *
+ * Parameters:
+ *		wrapper - pointer to a game optimizer wrapper instance obtained from scgms_game_optimize call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, optimalization successfully terminated and log file stored
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_optimizer_terminate(scgms_game_optimizer_wrapper_t wrapper);
@@ -1,403 +1,1668 @@
-/**
- * SmartCGMS - continuous glucose monitoring and controlling framework
- * https://diabetes.zcu.cz/
- *
- * Copyright (c) since 2018 University of West Bohemia.
- *
- * Contact:
- * diabetes@mail.kiv.zcu.cz
- * Medical Informatics, Department of Computer Science and Engineering
- * Faculty of Applied Sciences, University of West Bohemia
- * Univerzitni 8, 301 00 Pilsen
- * Czech Republic
- * 
- * 
- * Purpose of this software:
- * This software is intended to demonstrate work of the diabetes.zcu.cz research
- * group to other scientists, to complement our published papers. It is strictly
- * prohibited to use this software for diagnosis or treatment of any medical condition,
- * without obtaining all required approvals from respective regulatory bodies.
- *
- * Especially, a diabetic patient is warned that unauthorized use of this software
- * may result into severe injure, including death.
- *
- *
- * Licensing terms:
- * Unless required by applicable law or agreed to in writing, software
- * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- *
- * a) This file is available under the Apache License, Version 2.0.
- * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
- *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
- *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
- *    Volume 177, pp. 354-362, 2020
- */
-
-#include "game-wrapper.h"
-#include "configs.h"
-#include <scgms/rtl/referencedImpl.h>
-#include <scgms/utils/string_utils.h>
-#include <scgms/rtl/rattime.h>
-
-#include <iostream>
-
-#undef min
-#undef max
-
-CGame_Wrapper::CGame_Wrapper(uint32_t stepping_ms)
-	: mCurrent_Time{ 0.0 }, mStep_Size(scgms::One_Second* (static_cast<double>(stepping_ms) / 1000.0)), mSegment_Id{ 1 }, mConfig_GUID{ Invalid_GUID }, mParameters_GUID{ Invalid_GUID }
-{
-	//
-}
-
-CGame_Wrapper::~CGame_Wrapper()
-{
-
-}
-
-bool CGame_Wrapper::Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_path)
-{
-	mIs_Replay = false;
-
-	mConfig_GUID = Get_Config_Base_GUID(config_class, config_id);
-	mParameters_GUID = Get_Config_Parameters_GUID(config_class, config_id);
-
-	mConfig_Contents = Get_Config(mConfig_GUID, mParameters_GUID, mStep_Size, log_file_path, log_file_path, NConfig_Builder_Purpose::Gameplay);
-
-	return !mConfig_Contents.empty();
-}
-
-bool CGame_Wrapper::Load_Replay_Configuration(const std::string& log_file_path)
-{
-	mIs_Replay = true;
-
-	mConfig_Contents = Get_Replay_Config(log_file_path);
-
-	return !mConfig_Contents.empty();
-}
-
-bool CGame_Wrapper::Execute_Configuration()
-{
-	mErrors = refcnt::Swstr_list{};
-	scgms::SPersistent_Filter_Chain_Configuration configuration{};
-	if (configuration->Load_From_Memory(mConfig_Contents.c_str(), mConfig_Contents.length(), mErrors.get()) == S_OK)
-	{
-		scgms::SFilter_Executor ex{ configuration, nullptr, nullptr, mErrors, this };
-
-		mErrors.for_each([](const std::wstring& err) {
-			std::wcerr << "Error: " << err << std::endl;
-		});
-
-
-		if (!ex) {
-			return false;
-		}
-
-		mExecutor.reset(ex.get(), [](scgms::IFilter_Executor* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
-		ex.get()->AddRef();
-	}
-
-	if (!mExecutor)
-		return false;
-
-	mCurrent_Time = Unix_Time_To_Rat_Time(time(nullptr)); // at least preserve the initial timestamp (any further timestamps do not correspond to real-time)
-	mSegment_Id = 1;
-
-	// replays just gather all signals and terminate
-	if (mIs_Replay)
-		return true;
-
-	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Time_Segment_Start };
-
-	evt.level() = 0.0;
-	evt.device_time() = mCurrent_Time;
-	evt.signal_id() = Invalid_GUID;
-	evt.segment_id() = mSegment_Id;
-	evt.device_id() = game_wrapper_id;
-
-	auto rc = Succeeded(Inject_Event(std::move(evt)));
-	if (!rc)
-		return false;
-
-	return mExecutor.operator bool();
-}
-
-HRESULT IfaceCalling CGame_Wrapper::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description)
-{
-	return E_NOTIMPL;
-}
-
-HRESULT IfaceCalling CGame_Wrapper::Execute(scgms::IDevice_Event *event)
-{
-	scgms::UDevice_Event evt{ event };
-
-	if (evt.event_code() == scgms::NDevice_Event_Code::Level)
-	{
-		if (evt.signal_id() == scgms::signal_BG)
-			mState.bg = evt.level();
-		else if (evt.signal_id() == scgms::signal_IG)
-			mState.ig = evt.level();
-		else if (evt.signal_id() == scgms::signal_IOB)
-			mState.iob = evt.level();
-		else if (evt.signal_id() == scgms::signal_COB)
-			mState.cob = evt.level();
-	}
-
-	// on replay, store levels to be picked up by another thread
-	if (mIs_Replay && evt.event_code() == scgms::NDevice_Event_Code::Level)
-	{
-		std::unique_lock<std::mutex> lck(mReplay_Step_Mtx);
-
-		while (mPending_Signal && mExecutor)
-			mReplay_Step_Cv.wait(lck);
-
-		mPending_Signal = true;
-		mPending_Replay_Time = evt.device_time();
-		mPending_Replay_Level = evt.level();
-		mPending_Replay_Id = evt.signal_id();
-
-		mReplay_Step_Cv.notify_one();
-	}
-
-	if (mIs_Replay && evt.event_code() == scgms::NDevice_Event_Code::Shut_Down)
-	{
-		std::unique_lock<std::mutex> lck(mReplay_Step_Mtx);
-
-		mReplay_Ended = true;
-		mReplay_Step_Cv.notify_all();
-	}
-
-	// UDevice_Event destructor does this for us
-	//event->Release();
-
-	return S_OK;
-}
-
-bool CGame_Wrapper::Inject_Configuration_Info()
-{
-	std::unique_lock<std::mutex> lck(mExecution_Mtx);
-
-	std::wstring infoContents = L"Config_ID=" + GUID_To_WString(mConfig_GUID) + L",Parameters_ID=" + GUID_To_WString(mParameters_GUID);
-
-	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Information };
-	evt.device_id() = game_wrapper_id;
-	evt.device_time() = mCurrent_Time;
-	evt.segment_id() = mSegment_Id;
-	evt.info.set(infoContents.c_str());
-
-	return Succeeded(Inject_Event(std::move(evt)));
-}
-
-HRESULT CGame_Wrapper::Inject_Event(scgms::UDevice_Event &&event)
-{
-	if (!event)
-		return E_INVALIDARG;
-
-	scgms::IDevice_Event *raw_event = event.get();
-	event.release();
-	return mExecutor->Execute(raw_event);
-}
-
-bool CGame_Wrapper::Step(bool initial)
-{
-	std::unique_lock<std::mutex> lck(mExecution_Mtx);
-
-	// do not advance simulation time on initial step
-	if (!initial)
-		mCurrent_Time += mStep_Size;
-
-	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Level };
-
-	evt.level() = 0.0;
-	evt.device_time() = mCurrent_Time;
-	evt.signal_id() = scgms::signal_Synchronization;
-	evt.segment_id() = mSegment_Id;
-	evt.device_id() = game_wrapper_id;
-
-	return Succeeded(Inject_Event(std::move(evt)));
-}
-
-bool CGame_Wrapper::Replay_Step(GUID& id, double& level, double& time)
-{
-	if (!mIs_Replay || !mExecutor || mReplay_Ended)
-		return false;
-
-	// lock scope
-	{
-		std::unique_lock<std::mutex> lck(mReplay_Step_Mtx);
-
-		while (!mPending_Signal && mExecutor && !mReplay_Ended)
-			mReplay_Step_Cv.wait(lck);
-
-		if (!mPending_Signal)
-			return false;
-
-		mPending_Signal = false;
-		time = mPending_Replay_Time;
-		level = mPending_Replay_Level;
-		id = mPending_Replay_Id;
-
-		mReplay_Step_Cv.notify_one();
-	}
-
-	return true;
-}
-
-bool CGame_Wrapper::Inject_Level(GUID* signal_id, double level, double relative_step_time)
-{
-	std::unique_lock<std::mutex> lck(mExecution_Mtx);
-
-	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Level };
-
-	// ensure non-negative time; negative times may result in rejection by the discrete model
-	relative_step_time = std::max(0.0, relative_step_time);
-
-	evt.level() = level;
-	evt.device_time() = mCurrent_Time + mStep_Size * relative_step_time;
-	evt.signal_id() = *signal_id;
-	evt.segment_id() = mSegment_Id;
-	evt.device_id() = game_wrapper_id;
-
-	return Succeeded(Inject_Event(std::move(evt)));
-}
-
-void CGame_Wrapper::Terminate(const BOOL wait_for_shutdown)
-{
-	//Inject_Configuration_Info();
-	if (!mExecutor)
-		return;
-
-	std::unique_lock<std::mutex> lck(mExecution_Mtx);
-
-	if (!mIs_Replay)
-	{
-
-		scgms::UDevice_Event evt_stop{ scgms::NDevice_Event_Code::Time_Segment_Stop };
-
-		evt_stop.level() = 0.0;
-		evt_stop.device_time() = mCurrent_Time;
-		evt_stop.signal_id() = Invalid_GUID;
-		evt_stop.segment_id() = mSegment_Id;
-		evt_stop.device_id() = game_wrapper_id;
-
-		Inject_Event(std::move(evt_stop));
-	}
-
-	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Shut_Down };
-
-	evt.device_time() = mCurrent_Time;
-	evt.segment_id() = mSegment_Id;
-	evt.device_id() = game_wrapper_id;
-
-	Inject_Event(std::move(evt));
-
-	mExecutor->Terminate(wait_for_shutdown);
-
-	mExecutor.reset();
-}
-
-const CPatient_Sensor_State& CGame_Wrapper::Get_State() const
-{
-	return mState;
-}
-
-DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_create(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_path)
-{
-	std::unique_ptr<CGame_Wrapper> wrapper = std::make_unique<CGame_Wrapper>(stepping_ms);
-
-	if (!wrapper->Load_Configuration(config_class, config_id, log_file_path))
-		return nullptr;
-
-	if (!wrapper->Execute_Configuration())
-		return nullptr;
-
-	// make the first step, which initializes the model (and emits current state)
-	wrapper->Step(true);
-
-	auto res = wrapper.get();
-	wrapper.release();
-	return res;
-}
-
-DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_replay_create(const char* log_file_path)
-{
-	std::unique_ptr<CGame_Wrapper> wrapper = std::make_unique<CGame_Wrapper>(0);
-
-	if (!wrapper->Load_Replay_Configuration(log_file_path))
-		return nullptr;
-
-	if (!wrapper->Execute_Configuration())
-		return nullptr;
-
-	auto res = wrapper.get();
-	wrapper.release();
-	return res;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_step(scgms_game_wrapper_t wrapper_raw, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, double* bg, double* ig, double* iob, double* cob)
-{
-	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	// sort inputs by time, so the model gets stepped correctly
-	std::vector<size_t> input_indices(input_signal_count);
-	if (input_signal_count > 0) {
-		std::generate(input_indices.begin(), input_indices.end(), [n = 0]() mutable {
-			return n++;
-		});
-
-		std::sort(input_indices.begin(), input_indices.end(), [&input_signal_times](size_t a, size_t b) {
-			return input_signal_times[a] < input_signal_times[b];
-		});
-	}
-
-	for (uint32_t i = 0; i < input_signal_count; i++)
-	{
-		if (!wrapper->Inject_Level(&input_signal_ids[input_indices[i]], input_signal_levels[input_indices[i]], input_signal_times[input_indices[i]]))
-			return FALSE;
-	}
-
-	if (!wrapper->Step())
-		return FALSE;
-
-	auto state = wrapper->Get_State();
-	if (bg)
-		*bg = state.bg;
-	if (ig)
-		*ig = state.ig;
-	if (iob)
-		*iob = state.iob;
-	if (cob)
-		*cob = state.cob;
-
-	return TRUE;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_replay_step(scgms_game_wrapper_t wrapper_raw, GUID * signal_id, double* level, double* time)
-{
-	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	return wrapper->Replay_Step(*signal_id, *level, *time) ? TRUE : FALSE;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_get_additional_state(scgms_game_wrapper_t wrapper, GUID * requested_signal_ids, double* output_signal_levels, size_t signal_count)
-{
-	// TODO
-
-	return FALSE;
-}
-
-DLL_EXPORT BOOL IfaceCalling scgms_game_terminate(scgms_game_wrapper_t wrapper_raw)
-{
-	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
-	if (!wrapper)
-		return FALSE;
-
-	wrapper->Terminate(TRUE);
-
-	return TRUE;
-}
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "game-wrapper.h"
+#include "configs.h"
+#include "log-loader.h"
+#include "patient-db.h"
+#include "config-registry.h"
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/utils/string_utils.h>
+#include <scgms/rtl/rattime.h>
+
+#include <iostream>
+#include <string_view>
+#include <algorithm>
+#include <limits>
+
+#undef min
+#undef max
+
+namespace
+{
+	double Milliseconds_Between(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+	{
+		return std::chrono::duration<double, std::milli>(to - from).count();
+	}
+}
+
+CGame_Wrapper::CGame_Wrapper(uint32_t stepping_ms)
+	: mCurrent_Time{ 0.0 }, mStep_Size(scgms::One_Second* (static_cast<double>(stepping_ms) / 1000.0)), mSegment_Id{ 1 }, mConfig_GUID{ Invalid_GUID }, mParameters_GUID{ Invalid_GUID }
+{
+	//
+}
+
+CGame_Wrapper::~CGame_Wrapper()
+{
+	Stop_Simulation_Thread();
+	Stop_Record_Replay();
+}
+
+bool CGame_Wrapper::Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_path)
+{
+	mIs_Replay = false;
+
+	mConfig_GUID = Get_Config_Base_GUID(config_class, config_id);
+	mParameters_GUID = Get_Config_Parameters_GUID(config_class, config_id);
+
+	mLog_File_Path = log_file_path;
+
+	// no log file means no logging at all, so leave the log filter out of the chain
+	const NConfig_Builder_Purpose purpose = log_file_path.empty() ? NConfig_Builder_Purpose::Headless : NConfig_Builder_Purpose::Gameplay;
+
+	// sessions of the same parameters share the parsed configuration; just the log file path differs
+	mErrors = refcnt::Swstr_list{};
+
+	const bool profiled = Is_Filter_Profiling_Enabled() && Register_Profiling_Probe();
+
+	TConfiguration_Timing timing;
+	mConfiguration = CConfiguration_Cache::Instance().Get(mConfig_GUID, mParameters_GUID, mStep_Size, purpose, Is_Binary_Log_Path(log_file_path), profiled, mErrors, &timing);
+
+	if (mConfiguration && profiled)
+		mFilter_Profile = std::make_shared<CFilter_Profile>(mConfiguration->contents);
+
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Config_Build)] = timing.build_ms;
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Config_Parse)] = timing.parse_ms;
+
+	return mConfiguration != nullptr;
+}
+
+bool CGame_Wrapper::Load_Replay_Configuration(const std::string& log_file_path, size_t buffer_capacity, const TReplay_Filter& filter)
+{
+	mIs_Replay = true;
+	mReplay_Events = std::make_unique<CSPSC_Ring<TReplay_Event>>(buffer_capacity);
+	mReplay_Log_Path = log_file_path;
+	mReplay_Filter = filter;
+
+	// binary logs need no parsing, so they are read directly instead of through the log replay filter
+	if (Is_Binary_Log_Path(log_file_path))
+	{
+		mBinary_Replay = std::make_unique<CBinary_Log_Reader>();
+		return mBinary_Replay->Open(log_file_path);
+	}
+
+	mErrors = refcnt::Swstr_list{};
+
+	const auto build_start = std::chrono::steady_clock::now();
+	const std::string contents = Get_Replay_Config(log_file_path);
+	const auto parse_start = std::chrono::steady_clock::now();
+
+	mConfiguration = Parse_Configuration(contents, std::string::npos, mErrors);
+
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Config_Build)] = Milliseconds_Between(build_start, parse_start);
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Config_Parse)] = Milliseconds_Between(parse_start, std::chrono::steady_clock::now());
+
+	return mConfiguration != nullptr;
+}
+
+bool CGame_Wrapper::Execute_Configuration()
+{
+	Build_Signal_State_Table();
+
+	mJournal.clear();
+	mJournal_Run_Open = false;
+
+	if (mBinary_Replay)
+	{
+		// skip everything before the selected time range right away
+		const size_t first = std::isinf(mReplay_Filter.time_from) ? 0 : mBinary_Replay->Seek(mReplay_Filter.time_from);
+
+		mRecord_Replay_Thread = std::thread(&CGame_Wrapper::Record_Replay_Thread_Fnc, this, mBinary_Replay->begin() + first, mBinary_Replay->end());
+		return true;
+	}
+
+	const auto chain_start = std::chrono::steady_clock::now();
+
+	if (!Create_Chain(*mConfiguration, mLog_File_Path, this, mErrors, mExecutor, mOutput_Gate, mFilter_Profile))
+		return false;
+
+	const auto chain_end = std::chrono::steady_clock::now();
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Chain_Create)] = Milliseconds_Between(chain_start, chain_end);
+
+	mCurrent_Time = Unix_Time_To_Rat_Time(time(nullptr)); // at least preserve the initial timestamp (any further timestamps do not correspond to real-time)
+	mSegment_Id = 1;
+
+	// replays just gather all signals and terminate
+	if (mIs_Replay)
+	{
+		mStartup_Profile[static_cast<size_t>(NStartup_Phase::Total)] = Milliseconds_Between(mCreation_Time, chain_end);
+		return true;
+	}
+
+	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Time_Segment_Start };
+
+	evt.level() = 0.0;
+	evt.device_time() = mCurrent_Time;
+	evt.signal_id() = Invalid_GUID;
+	evt.segment_id() = mSegment_Id;
+	evt.device_id() = game_wrapper_id;
+
+	auto rc = Succeeded(Inject_Event(std::move(evt)));
+	if (!rc)
+		return false;
+
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Segment_Start)] = Milliseconds_Between(chain_end, std::chrono::steady_clock::now());
+
+	return mExecutor.operator bool();
+}
+
+bool CGame_Wrapper::Create_Chain(TParsed_Configuration& configuration, const std::string& log_file_path, scgms::IFilter* target, refcnt::Swstr_list& errors,
+	scgms::SFilter_Executor& executor, std::unique_ptr<CChain_Output_Gate>& gate, const std::shared_ptr<CFilter_Profile>& profile)
+{
+	std::unique_ptr<CBinary_Log_Writer> log;
+	if (Is_Binary_Log_Path(log_file_path))
+	{
+		log = std::make_unique<CBinary_Log_Writer>();
+		if (!log->Open(log_file_path))
+			return false;
+	}
+
+	auto new_gate = std::make_unique<CChain_Output_Gate>(target, std::move(log));
+
+	// the configuration is shared; the log file path must stay patched until the chain is created
+	std::unique_lock<std::mutex> lck(configuration.mtx);
+
+	if (configuration.log_file_parameter && !Succeeded(configuration.log_file_parameter.set_wstring(Widen_String(log_file_path).c_str())))
+		return false;
+
+	scgms::SFilter_Executor ex{ configuration.configuration, profile ? &Attach_Profile_On_Filter_Created : nullptr, &profile, errors, new_gate.get() };
+
+	lck.unlock();
+
+	errors.for_each([](const std::wstring& err) {
+		std::wcerr << "Error: " << err << std::endl;
+	});
+
+	if (!ex)
+		return false;
+
+	executor.reset(ex.get(), [](scgms::IFilter_Executor* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+	ex.get()->AddRef();
+
+	gate = std::move(new_gate);
+
+	return true;
+}
+
+void CGame_Wrapper::Record_Replay_Thread_Fnc(const TBinary_Log_Record* begin, const TBinary_Log_Record* end)
+{
+	for (auto rec = begin; rec != end; rec++)
+	{
+		if (rec->event_code != static_cast<uint32_t>(scgms::NDevice_Event_Code::Level) || !mReplay_Filter.Accepts(rec->signal_id, rec->device_time))
+			continue;
+
+		// the ring gets closed on termination or seek
+		if (!mReplay_Events->Push(TReplay_Event{ rec->signal_id, rec->level, rec->device_time }))
+			break;
+	}
+
+	mReplay_Events->Close();
+}
+
+void CGame_Wrapper::Stop_Record_Replay()
+{
+	if (!mRecord_Replay_Thread.joinable())
+		return;
+
+	mReplay_Events->Close();
+	mRecord_Replay_Thread.join();
+}
+
+void CGame_Wrapper::Shut_Down_Chain(scgms::SFilter_Executor& executor, double current_time, uint64_t segment_id, bool stop_segment, const BOOL wait_for_shutdown)
+{
+	if (!executor)
+		return;
+
+	if (stop_segment)
+	{
+		scgms::UDevice_Event evt_stop{ scgms::NDevice_Event_Code::Time_Segment_Stop };
+
+		evt_stop.level() = 0.0;
+		evt_stop.device_time() = current_time;
+		evt_stop.signal_id() = Invalid_GUID;
+		evt_stop.segment_id() = segment_id;
+		evt_stop.device_id() = game_wrapper_id;
+
+		scgms::IDevice_Event* raw_stop = evt_stop.get();
+		evt_stop.release();
+		executor->Execute(raw_stop);
+	}
+
+	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Shut_Down };
+
+	evt.device_time() = current_time;
+	evt.segment_id() = segment_id;
+	evt.device_id() = game_wrapper_id;
+
+	scgms::IDevice_Event* raw_evt = evt.get();
+	evt.release();
+	executor->Execute(raw_evt);
+
+	executor->Terminate(wait_for_shutdown);
+
+	executor.reset();
+}
+
+void CGame_Wrapper::Build_Signal_State_Table()
+{
+	mSignal_States.Clear();
+	mState = CPatient_Sensor_State{};
+
+	mSignal_States.Find_Or_Add(scgms::signal_BG);
+	mSignal_States.Find_Or_Add(scgms::signal_IG);
+	mSignal_States.Find_Or_Add(scgms::signal_IOB);
+	mSignal_States.Find_Or_Add(scgms::signal_COB);
+
+	// binary replays have no configuration
+	if (!mConfiguration)
+		return;
+
+	// pre-register every signal the configuration maps to or calculates, so the table does not grow during the simulation;
+	// signals emitted directly by models get their slot on their first occurrence
+	const std::string_view contents{ mConfiguration->contents };
+	for (const std::string_view key : { std::string_view{ "Signal_Dst_Id" }, std::string_view{ "Signal" } })
+	{
+		size_t pos = 0;
+		while ((pos = contents.find(key, pos)) != std::string_view::npos)
+		{
+			const bool line_start = (pos == 0 || contents[pos - 1] == '\n' || contents[pos - 1] == '\r');
+			pos += key.length();
+
+			// the key must span the whole parameter name, i.e.; start the line and be followed by a value assignment
+			if (!line_start)
+				continue;
+
+			const size_t assign = contents.find_first_not_of(' ', pos);
+			if (assign == std::string_view::npos || contents[assign] != '=')
+				continue;
+
+			const size_t begin = contents.find('{', assign);
+			const size_t end = contents.find('}', assign);
+			const size_t eol = contents.find('\n', assign);
+			if (begin == std::string_view::npos || end == std::string_view::npos || end < begin || (eol != std::string_view::npos && eol < end))
+				continue;
+
+			bool ok = false;
+			const GUID id = WString_To_GUID(Widen_String(std::string{ contents.substr(begin, end - begin + 1) }), ok);
+			if (ok)
+				mSignal_States.Find_Or_Add(id);
+		}
+	}
+}
+
+bool CGame_Wrapper::Get_Additional_State(const GUID* signal_ids, double* levels, size_t count)
+{
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	bool all_found = true;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const size_t slot = mSignal_States.Find(signal_ids[i]);
+		if (slot == CSignal_State_Table::Invalid_Slot)
+		{
+			levels[i] = std::numeric_limits<double>::quiet_NaN();
+			all_found = false;
+		}
+		else
+		{
+			levels[i] = mSignal_States.Get_Level(slot);
+			if (std::isnan(levels[i]))
+				all_found = false;
+		}
+	}
+
+	return all_found;
+}
+
+HRESULT IfaceCalling CGame_Wrapper::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT IfaceCalling CGame_Wrapper::Execute(scgms::IDevice_Event *event)
+{
+	scgms::UDevice_Event evt{ event };
+
+	// replays are read through Replay_Step, the state table is not accessible for them
+	if (!mIs_Replay && evt.event_code() == scgms::NDevice_Event_Code::Level)
+	{
+		const size_t slot = mSignal_States.Find_Or_Add(evt.signal_id());
+		mSignal_States.Set_Level(slot, evt.level());
+
+		switch (slot)
+		{
+			case Slot_BG: mState.bg = evt.level(); break;
+			case Slot_IG: mState.ig = evt.level(); break;
+			case Slot_IOB: mState.iob = evt.level(); break;
+			case Slot_COB: mState.cob = evt.level(); break;
+			default: break;
+		}
+	}
+
+	// on replay, store selected levels to be picked up by another thread; blocks only if the outer code lags behind by the whole buffer
+	// the log replay filter cannot select events by itself, so the selection of CSV replays happens here, after the whole log has been parsed
+	if (mIs_Replay && evt.event_code() == scgms::NDevice_Event_Code::Level && mReplay_Filter.Accepts(evt.signal_id(), evt.device_time()))
+		mReplay_Events->Push(TReplay_Event{ evt.signal_id(), evt.level(), evt.device_time() });
+
+	if (mIs_Replay && evt.event_code() == scgms::NDevice_Event_Code::Shut_Down)
+		mReplay_Events->Close();
+
+	// UDevice_Event destructor does this for us
+	//event->Release();
+
+	return S_OK;
+}
+
+bool CGame_Wrapper::Inject_Configuration_Info()
+{
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	std::wstring infoContents = L"Config_ID=" + GUID_To_WString(mConfig_GUID) + L",Parameters_ID=" + GUID_To_WString(mParameters_GUID);
+
+	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Information };
+	evt.device_id() = game_wrapper_id;
+	evt.device_time() = mCurrent_Time;
+	evt.segment_id() = mSegment_Id;
+	evt.info.set(infoContents.c_str());
+
+	return Succeeded(Inject_Event(std::move(evt)));
+}
+
+HRESULT CGame_Wrapper::Inject_Event(scgms::UDevice_Event &&event)
+{
+	if (!event)
+		return E_INVALIDARG;
+
+	// journal everything that determines the state of the chain, so the state can be reproduced later
+	if (!mIs_Replay && (event.event_code() == scgms::NDevice_Event_Code::Level || event.event_code() == scgms::NDevice_Event_Code::Time_Segment_Start))
+		Journal_Event(event);
+
+	scgms::IDevice_Event *raw_event = event.get();
+	event.release();
+	return mExecutor->Execute(raw_event);
+}
+
+void CGame_Wrapper::Journal_Event(const scgms::UDevice_Event& event)
+{
+	// every step injects a synchronization event, so long stretches without inputs collapse into a single entry
+	const bool is_step = event.event_code() == scgms::NDevice_Event_Code::Level && event.signal_id() == scgms::signal_Synchronization;
+	if (is_step && mJournal_Run_Open)
+	{
+		TJournal_Entry& last = mJournal.back();
+		if (last.segment_id == event.segment_id() && last.level == event.level() && last.repeat_count < std::numeric_limits<uint32_t>::max())
+		{
+			const double step = (last.repeat_count == 1) ? event.device_time() - last.device_time : last.repeat_step;
+
+			// the replay accumulates the step the same way, so the times must match exactly
+			if (step > 0.0 && mJournal_Last_Time + step == event.device_time())
+			{
+				last.repeat_step = step;
+				last.repeat_count++;
+				mJournal_Last_Time = event.device_time();
+				return;
+			}
+		}
+	}
+
+	mJournal.push_back(TJournal_Entry{ event.event_code(), event.signal_id(), event.level(), event.device_time(), event.segment_id(), 1, 0.0 });
+	mJournal_Run_Open = is_step;
+	mJournal_Last_Time = event.device_time();
+}
+
+bool CGame_Wrapper::Step(bool initial)
+{
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	if (!initial)
+		return Step_Unlocked(false);
+
+	// the initial step concludes the start-up
+	const auto step_start = std::chrono::steady_clock::now();
+	const bool result = Step_Unlocked(true);
+	const auto step_end = std::chrono::steady_clock::now();
+
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Initial_Step)] = Milliseconds_Between(step_start, step_end);
+	mStartup_Profile[static_cast<size_t>(NStartup_Phase::Total)] = Milliseconds_Between(mCreation_Time, step_end);
+
+	return result;
+}
+
+const std::array<double, static_cast<size_t>(NStartup_Phase::count)>& CGame_Wrapper::Get_Startup_Profile() const
+{
+	return mStartup_Profile;
+}
+
+const CFilter_Profile* CGame_Wrapper::Get_Filter_Profile() const
+{
+	return mFilter_Profile.get();
+}
+
+bool CGame_Wrapper::Step_Unlocked(bool initial)
+{
+	// do not advance simulation time on initial step
+	if (!initial)
+		mCurrent_Time += mStep_Size;
+
+	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Level };
+
+	evt.level() = 0.0;
+	evt.device_time() = mCurrent_Time;
+	evt.signal_id() = scgms::signal_Synchronization;
+	evt.segment_id() = mSegment_Id;
+	evt.device_id() = game_wrapper_id;
+
+	return Succeeded(Inject_Event(std::move(evt)));
+}
+
+bool CGame_Wrapper::Step_With_Inputs(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count)
+{
+	if (mIs_Replay || !mExecutor)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	return Step_With_Inputs_Unlocked(signal_ids, levels, relative_times, count);
+}
+
+bool CGame_Wrapper::Step_With_Inputs_Unlocked(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count)
+{
+	if (count > 0)
+	{
+		// sort inputs by time, so the model gets stepped correctly
+		mInput_Order.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+			mInput_Order[i] = i;
+
+		std::sort(mInput_Order.begin(), mInput_Order.end(), [relative_times](uint32_t a, uint32_t b) {
+			return relative_times[a] < relative_times[b];
+		});
+
+		for (const uint32_t idx : mInput_Order)
+		{
+			if (!Inject_Level_Unlocked(signal_ids[idx], levels[idx], relative_times[idx]))
+				return false;
+		}
+	}
+
+	return Step_Unlocked(false);
+}
+
+bool CGame_Wrapper::Step_N(uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* relative_times, const uint32_t* input_offsets,
+	double* bg, double* ig, double* iob, double* cob)
+{
+	if (mIs_Replay || !mExecutor)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	for (uint32_t i = 0; i < n_steps; i++)
+	{
+		const uint32_t first = input_offsets ? input_offsets[i] : 0;
+		const uint32_t count = input_offsets ? (input_offsets[i + 1] - first) : 0;
+
+		if (!Step_With_Inputs_Unlocked(signal_ids + first, levels + first, relative_times + first, count))
+			return false;
+
+		if (bg)
+			bg[i] = mState.bg;
+		if (ig)
+			ig[i] = mState.ig;
+		if (iob)
+			iob[i] = mState.iob;
+		if (cob)
+			cob[i] = mState.cob;
+	}
+
+	return true;
+}
+
+namespace
+{
+	// statistics of a single signal within a decimation window
+	struct TWindow_Stats
+	{
+		double min = std::numeric_limits<double>::quiet_NaN();
+		double max = std::numeric_limits<double>::quiet_NaN();
+		double sum = 0;
+		size_t count = 0;
+
+		void Add(double level)
+		{
+			if (std::isnan(level))
+				return;
+
+			min = (count == 0) ? level : std::min(min, level);
+			max = (count == 0) ? level : std::max(max, level);
+			sum += level;
+			count++;
+		}
+
+		// stores minimum, maximum and mean to target (if not nullptr) and resets the window
+		void Flush(double* target)
+		{
+			if (target)
+			{
+				target[0] = min;
+				target[1] = max;
+				target[2] = (count > 0) ? sum / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+			}
+
+			*this = TWindow_Stats{};
+		}
+	};
+}
+
+bool CGame_Wrapper::Fast_Forward(uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* times, uint32_t count,
+	NGame_Decimation decimation, uint32_t k, double* bg, double* ig, double* iob, double* cob, uint32_t& output_count)
+{
+	output_count = 0;
+
+	if (mIs_Replay || k == 0)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	TWindow_Stats bg_stats, ig_stats, iob_stats, cob_stats;
+	uint32_t next_input = 0;
+
+	for (uint32_t step = 0; step < n_steps; step++)
+	{
+		// inject all inputs scheduled within this step
+		const double step_end = static_cast<double>(step) + 1.0;
+		for (; next_input < count && times[next_input] < step_end; next_input++)
+		{
+			if (!Inject_Level_Unlocked(signal_ids[next_input], levels[next_input], times[next_input] - static_cast<double>(step)))
+				return false;
+		}
+
+		if (!Step_Unlocked(false))
+			return false;
+
+		const bool sample_end = ((step + 1) % k == 0);
+
+		if (decimation == NGame_Decimation::Every_Kth_Step)
+		{
+			if (sample_end)
+			{
+				if (bg)
+					bg[output_count] = mState.bg;
+				if (ig)
+					ig[output_count] = mState.ig;
+				if (iob)
+					iob[output_count] = mState.iob;
+				if (cob)
+					cob[output_count] = mState.cob;
+
+				output_count++;
+			}
+		}
+		else
+		{
+			bg_stats.Add(mState.bg);
+			ig_stats.Add(mState.ig);
+			iob_stats.Add(mState.iob);
+			cob_stats.Add(mState.cob);
+
+			// the last window may be shorter
+			if (sample_end || step + 1 == n_steps)
+			{
+				const size_t offset = static_cast<size_t>(output_count) * 3;
+
+				bg_stats.Flush(bg ? bg + offset : nullptr);
+				ig_stats.Flush(ig ? ig + offset : nullptr);
+				iob_stats.Flush(iob ? iob + offset : nullptr);
+				cob_stats.Flush(cob ? cob + offset : nullptr);
+
+				output_count++;
+			}
+		}
+	}
+
+	return true;
+}
+
+uint64_t CGame_Wrapper::Step_Async(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count)
+{
+	if (mIs_Replay || !mExecutor)
+		return 0;
+
+	TAsync_Step_Command cmd;
+	cmd.signal_ids.assign(signal_ids, signal_ids + count);
+	cmd.levels.assign(levels, levels + count);
+	cmd.relative_times.assign(relative_times, relative_times + count);
+
+	std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+	if (mAsync_Stop)
+		return 0;
+
+	if (!mSimulation_Thread)
+		mSimulation_Thread = std::make_unique<std::thread>(&CGame_Wrapper::Simulation_Thread_Fnc, this);
+
+	cmd.ticket = mNext_Ticket++;
+	const uint64_t ticket = cmd.ticket;
+
+	mAsync_Commands.push_back(std::move(cmd));
+	mAsync_Command_Cv.notify_one();
+
+	return ticket;
+}
+
+void CGame_Wrapper::Simulation_Thread_Fnc()
+{
+	std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+	while (true)
+	{
+		mAsync_Command_Cv.wait(lck, [this]() { return mAsync_Stop || !mAsync_Commands.empty(); });
+
+		// stop only after all accepted steps are performed
+		if (mAsync_Commands.empty())
+			break;
+
+		TAsync_Step_Command cmd = std::move(mAsync_Commands.front());
+		mAsync_Commands.pop_front();
+
+		lck.unlock();
+
+		TAsync_Step_Result result;
+
+		// execution lock scope
+		{
+			std::unique_lock<std::mutex> exec_lck(mExecution_Mtx);
+
+			result.succeeded = Step_With_Inputs_Unlocked(cmd.signal_ids.data(), cmd.levels.data(), cmd.relative_times.data(), static_cast<uint32_t>(cmd.signal_ids.size()));
+			result.state = mState;
+		}
+
+		lck.lock();
+
+		mAsync_Results[cmd.ticket] = result;
+		mLast_Completed_Ticket = cmd.ticket;
+
+		// tickets complete in order, so just one result falls out of the window with each step; keeps fire-and-forget callers from piling the results up
+		if (cmd.ticket > Max_Async_Result_Count)
+			mAsync_Results.erase(cmd.ticket - Max_Async_Result_Count);
+
+		mAsync_Result_Cv.notify_all();
+	}
+}
+
+void CGame_Wrapper::Stop_Simulation_Thread()
+{
+	// lock scope
+	{
+		std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+		mAsync_Stop = true;
+		mAsync_Command_Cv.notify_all();
+	}
+
+	if (mSimulation_Thread)
+	{
+		if (mSimulation_Thread->joinable())
+			mSimulation_Thread->join();
+
+		mSimulation_Thread.reset();
+	}
+}
+
+NGame_Step_State CGame_Wrapper::Take_Async_Result(uint64_t ticket, CPatient_Sensor_State& state)
+{
+	auto itr = mAsync_Results.find(ticket);
+	if (itr == mAsync_Results.end())
+		return (ticket > mLast_Completed_Ticket && ticket < mNext_Ticket) ? NGame_Step_State::Pending : NGame_Step_State::Unknown;
+
+	const bool succeeded = itr->second.succeeded;
+	state = itr->second.state;
+	mAsync_Results.erase(itr);
+
+	return succeeded ? NGame_Step_State::Done : NGame_Step_State::Failed;
+}
+
+NGame_Step_State CGame_Wrapper::Poll_Step(uint64_t ticket, CPatient_Sensor_State& state)
+{
+	std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+	return Take_Async_Result(ticket, state);
+}
+
+NGame_Step_State CGame_Wrapper::Wait_Step(uint64_t ticket, uint32_t timeout_ms, CPatient_Sensor_State& state)
+{
+	std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+	auto performed = [this, ticket]() { return ticket <= mLast_Completed_Ticket || ticket >= mNext_Ticket; };
+
+	if (timeout_ms == Infinite_Wait_Timeout)
+		mAsync_Result_Cv.wait(lck, performed);
+	else
+		mAsync_Result_Cv.wait_for(lck, std::chrono::milliseconds(timeout_ms), performed);
+
+	return Take_Async_Result(ticket, state);
+}
+
+void CGame_Wrapper::Wait_Async_Idle()
+{
+	// no asynchronous step has ever been requested; the thread is started only by the thread that issues the synchronous calls
+	if (!mSimulation_Thread)
+		return;
+
+	std::unique_lock<std::mutex> lck(mAsync_Mtx);
+
+	mAsync_Result_Cv.wait(lck, [this]() { return mLast_Completed_Ticket + 1 == mNext_Ticket; });
+}
+
+namespace
+{
+	// runs fnc(index) for all indices <0; count) on a pool of worker threads; returns true, if all calls succeeded
+	template <typename TFnc>
+	bool Run_Parallel(size_t count, TFnc&& fnc)
+	{
+		const size_t worker_count = std::min(count, static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));
+
+		std::atomic<size_t> next_index{ 0 };
+		std::atomic<bool> succeeded{ true };
+
+		auto worker = [&]() {
+			for (size_t index = next_index++; index < count; index = next_index++)
+			{
+				if (!fnc(index))
+					succeeded = false;
+			}
+		};
+
+		// the calling thread is one of the workers
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < worker_count; i++)
+			workers.emplace_back(worker);
+
+		worker();
+
+		for (auto& thread : workers)
+			thread.join();
+
+		return succeeded;
+	}
+
+	// passes events journaled in <begin; end) to inject in their original order; returns true, if all injections succeeded
+	template <typename TInject>
+	bool Replay_Journal(const TJournal_Entry* begin, const TJournal_Entry* end, TInject&& inject)
+	{
+		for (const TJournal_Entry* entry = begin; entry != end; entry++)
+		{
+			double device_time = entry->device_time;
+			for (uint32_t i = 0; i < entry->repeat_count; i++, device_time += entry->repeat_step)
+			{
+				scgms::UDevice_Event evt{ entry->event_code };
+
+				evt.level() = entry->level;
+				evt.device_time() = device_time;
+				evt.signal_id() = entry->signal_id;
+				evt.segment_id() = entry->segment_id;
+				evt.device_id() = game_wrapper_id;
+
+				if (!inject(std::move(evt)))
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+bool CGame_Wrapper::Fork(uint32_t count, std::vector<std::unique_ptr<CGame_Wrapper>>& forks)
+{
+	forks.clear();
+
+	if (mIs_Replay || !mExecutor || count == 0)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	refcnt::Swstr_list errors;
+	const auto config = CConfiguration_Cache::Instance().Get(mConfig_GUID, mParameters_GUID, mStep_Size, NConfig_Builder_Purpose::Headless, false, false, errors);
+	if (!config)
+		return false;
+
+	forks.resize(count);
+
+	// filters do not expose their internal state, so each fork reaches the current state by replaying the journal in its own chain
+	const bool succeeded = Run_Parallel(count, [this, &config, &forks](size_t index) {
+
+		auto fork = std::make_unique<CGame_Wrapper>(0);
+
+		fork->mIs_Replay = false;
+		fork->mIs_Fork = true;
+		fork->mStep_Size = mStep_Size;
+		fork->mConfig_GUID = mConfig_GUID;
+		fork->mParameters_GUID = mParameters_GUID;
+		fork->mConfiguration = config;
+		fork->mSegment_Id = mSegment_Id;
+
+		fork->Build_Signal_State_Table();
+
+		if (!Create_Chain(*config, "", fork.get(), fork->mErrors, fork->mExecutor, fork->mOutput_Gate))
+			return false;
+
+		const bool replayed = Replay_Journal(mJournal.data(), mJournal.data() + mJournal.size(), [&fork](scgms::UDevice_Event&& evt) {
+			return Succeeded(fork->Inject_Event(std::move(evt)));
+		});
+		if (!replayed)
+			return false;
+
+		fork->mCurrent_Time = mCurrent_Time;
+		fork->mState = mState;
+		fork->mSignal_States = mSignal_States;
+
+		forks[index] = std::move(fork);
+
+		return true;
+	});
+
+	if (!succeeded)
+	{
+		for (auto& fork : forks)
+		{
+			if (fork)
+				fork->Terminate(TRUE);
+		}
+
+		forks.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool CGame_Wrapper::Evaluate_Forks(CGame_Wrapper* const* forks, uint32_t fork_count, uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* times,
+	const uint32_t* input_fork_offsets, double* bg, double* ig, double* iob, double* cob)
+{
+	return Run_Parallel(fork_count, [=](size_t index) {
+
+		const uint32_t first_input = input_fork_offsets ? input_fork_offsets[index] : 0;
+		const uint32_t input_count = input_fork_offsets ? input_fork_offsets[index + 1] - first_input : 0;
+		const size_t output_offset = index * static_cast<size_t>(n_steps);
+
+		uint32_t output_count = 0;
+		return forks[index]->Fast_Forward(n_steps, signal_ids + first_input, levels + first_input, times + first_input, input_count,
+			NGame_Decimation::Every_Kth_Step, 1,
+			bg ? bg + output_offset : nullptr, ig ? ig + output_offset : nullptr, iob ? iob + output_offset : nullptr, cob ? cob + output_offset : nullptr,
+			output_count);
+	});
+}
+
+bool CGame_Wrapper::Is_Fork() const
+{
+	return mIs_Fork;
+}
+
+bool CGame_Wrapper::Replay_Step(GUID& id, double& level, double& time)
+{
+	if (!mIs_Replay || !mReplay_Events)
+		return false;
+
+	TReplay_Event evt;
+	if (!mReplay_Events->Pop(evt))
+		return false;
+
+	id = evt.signal_id;
+	level = evt.level;
+	time = evt.device_time;
+
+	return true;
+}
+
+bool CGame_Wrapper::Replay_Read(size_t max_events, GUID* ids, double* levels, double* times, size_t& count)
+{
+	count = 0;
+
+	if (!mIs_Replay || !mReplay_Events)
+		return false;
+
+	// drain whatever is buffered, up to the capacity of output arrays
+	while (count < max_events)
+	{
+		const size_t read = mReplay_Events->Pop_Bulk(max_events - count, [=](const TReplay_Event& evt, size_t i) {
+			ids[count + i] = evt.signal_id;
+			levels[count + i] = evt.level;
+			times[count + i] = evt.device_time;
+		});
+
+		if (read == 0)
+			break;
+
+		count += read;
+
+		// do not wait for more events, if we already have some to return
+		if (mReplay_Events->Is_Empty())
+			break;
+	}
+
+	return count > 0;
+}
+
+bool CGame_Wrapper::Replay_Seek(double time)
+{
+	if (!mIs_Replay || !mReplay_Events)
+		return false;
+
+	// stop the current replay, whatever it is
+	mReplay_Events->Close();
+	Stop_Record_Replay();
+
+	// there is nothing to replay before the selected time range
+	time = std::max(time, mReplay_Filter.time_from);
+
+	const TBinary_Log_Record* begin = nullptr;
+	const TBinary_Log_Record* end = nullptr;
+
+	if (mBinary_Replay)
+	{
+		begin = mBinary_Replay->begin() + mBinary_Replay->Seek(time);
+		end = mBinary_Replay->end();
+	}
+	else
+	{
+		// CSV log cannot be seeked; it is read whole just once and replayed from memory since then
+		if (mExecutor)
+		{
+			Shut_Down_Chain(mExecutor, mCurrent_Time, mSegment_Id, false, TRUE);
+
+			TLog_Level_Columns columns;
+			if (!Load_Log_Level_Events(mReplay_Log_Path, columns))
+				return false;
+
+			// keep just the selected events
+			mReplay_Records.clear();
+			for (size_t i = 0; i < columns.Size(); i++)
+			{
+				if (!mReplay_Filter.Accepts(columns.signal_ids[i], columns.device_times[i]))
+					continue;
+
+				TBinary_Log_Record rec{};
+				rec.device_time = columns.device_times[i];
+				rec.level = columns.levels[i];
+				rec.signal_id = columns.signal_ids[i];
+				rec.event_code = static_cast<uint32_t>(scgms::NDevice_Event_Code::Level);
+
+				mReplay_Records.push_back(rec);
+			}
+
+			mReplay_Records_Index.Build(mReplay_Records.data(), mReplay_Records.data() + mReplay_Records.size());
+		}
+
+		begin = mReplay_Records.data() + mReplay_Records_Index.Seek(mReplay_Records.data(), mReplay_Records.size(), time);
+		end = mReplay_Records.data() + mReplay_Records.size();
+	}
+
+	mReplay_Events->Reset();
+	mRecord_Replay_Thread = std::thread(&CGame_Wrapper::Record_Replay_Thread_Fnc, this, begin, end);
+
+	return true;
+}
+
+bool CGame_Wrapper::Inject_Level(GUID* signal_id, double level, double relative_step_time)
+{
+	if (mIs_Replay || !mExecutor)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	return Inject_Level_Unlocked(*signal_id, level, relative_step_time);
+}
+
+bool CGame_Wrapper::Inject_Level_Unlocked(const GUID& signal_id, double level, double relative_step_time)
+{
+	scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Level };
+
+	// ensure non-negative time; negative times may result in rejection by the discrete model
+	relative_step_time = std::max(0.0, relative_step_time);
+
+	evt.level() = level;
+	evt.device_time() = mCurrent_Time + mStep_Size * relative_step_time;
+	evt.signal_id() = signal_id;
+	evt.segment_id() = mSegment_Id;
+	evt.device_id() = game_wrapper_id;
+
+	return Succeeded(Inject_Event(std::move(evt)));
+}
+
+void CGame_Wrapper::Terminate(const BOOL wait_for_shutdown)
+{
+	// finish all queued steps first, so they are not lost in the log
+	Stop_Simulation_Thread();
+
+	// replays from records have no chain, just stop passing the records
+	Stop_Record_Replay();
+
+	//Inject_Configuration_Info();
+	if (!mExecutor)
+		return;
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	// release the log replay, if it waits for the outer code to take buffered events
+	if (mIs_Replay)
+		mReplay_Events->Close();
+
+	mCheckpoints.clear();
+
+	Shut_Down_Chain(mExecutor, mCurrent_Time, mSegment_Id, !mIs_Replay, wait_for_shutdown);
+}
+
+uint32_t CGame_Wrapper::Checkpoint()
+{
+	if (mIs_Replay || !mExecutor)
+		return 0;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	if (mCheckpoints.size() >= Max_Checkpoint_Count)
+		mCheckpoints.pop_front();
+
+	const uint32_t id = mNext_Checkpoint_Id++;
+	mCheckpoints.push_back(TCheckpoint{ id, mCurrent_Time, mState, mSignal_States, mJournal.size() });
+
+	// the last journal entry belongs to the checkpoint now, so further steps must not extend it
+	mJournal_Run_Open = false;
+
+	return id;
+}
+
+bool CGame_Wrapper::Rebuild_Chain_Unlocked(size_t journal_length)
+{
+	// the log file cannot be opened by the new chain, until the current one closes it
+	mOutput_Gate->Set_Target(nullptr);
+	Shut_Down_Chain(mExecutor, mCurrent_Time, mSegment_Id, true, TRUE);
+	mOutput_Gate.reset();
+
+	scgms::SFilter_Executor executor;
+	std::unique_ptr<CChain_Output_Gate> gate;
+
+	// the new chain stays detached during the re-simulation, so the replayed outputs are not taken as the current state
+	if (!Create_Chain(*mConfiguration, mLog_File_Path, nullptr, mErrors, executor, gate, mFilter_Profile))
+		return false;
+
+	const bool replayed = Replay_Journal(mJournal.data(), mJournal.data() + journal_length, [&executor](scgms::UDevice_Event&& evt) {
+		scgms::IDevice_Event* raw_event = evt.get();
+		evt.release();
+		return Succeeded(executor->Execute(raw_event));
+	});
+
+	if (!replayed)
+	{
+		Shut_Down_Chain(executor, mCurrent_Time, mSegment_Id, true, TRUE);
+		return false;
+	}
+
+	mExecutor = std::move(executor);
+	mOutput_Gate = std::move(gate);
+	mOutput_Gate->Set_Target(this);
+
+	return true;
+}
+
+bool CGame_Wrapper::Restore(uint32_t checkpoint_id)
+{
+	if (mIs_Replay || !mExecutor)
+		return false;
+
+	Wait_Async_Idle();
+
+	std::unique_lock<std::mutex> lck(mExecution_Mtx);
+
+	auto itr = std::find_if(mCheckpoints.begin(), mCheckpoints.end(), [checkpoint_id](const TCheckpoint& checkpoint) { return checkpoint.id == checkpoint_id; });
+	if (itr == mCheckpoints.end())
+		return false;
+
+	// filters do not expose their internal state, so the chain is brought to the checkpoint state by re-simulating the history up to it
+	if (!Rebuild_Chain_Unlocked(itr->journal_length))
+	{
+		mCheckpoints.clear();
+		return false;
+	}
+
+	mCurrent_Time = itr->current_time;
+	mState = itr->state;
+	mSignal_States = itr->signal_states;
+	mJournal.resize(itr->journal_length);
+	mJournal_Run_Open = false;
+
+	// checkpoints created after the restored one belong to the abandoned history
+	mCheckpoints.erase(std::next(itr), mCheckpoints.end());
+
+	return true;
+}
+
+std::string CGame_Wrapper::Get_Log_File_Path() const
+{
+	return mLog_File_Path;
+}
+
+const CPatient_Sensor_State& CGame_Wrapper::Get_State() const
+{
+	return mState;
+}
+
+// copies the sensor state to output variables, that are not nullptr
+static void Store_State(const CPatient_Sensor_State& state, double* bg, double* ig, double* iob, double* cob)
+{
+	if (bg)
+		*bg = state.bg;
+	if (ig)
+		*ig = state.ig;
+	if (iob)
+		*iob = state.iob;
+	if (cob)
+		*cob = state.cob;
+}
+
+DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_create(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_path)
+{
+	std::unique_ptr<CGame_Wrapper> wrapper = std::make_unique<CGame_Wrapper>(stepping_ms);
+
+	if (!wrapper->Load_Configuration(config_class, config_id, log_file_path ? log_file_path : ""))
+		return nullptr;
+
+	if (!wrapper->Execute_Configuration())
+		return nullptr;
+
+	// make the first step, which initializes the model (and emits current state)
+	wrapper->Step(true);
+
+	auto res = wrapper.get();
+	wrapper.release();
+	return res;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_load_catalogue(const char* catalogue_path)
+{
+	if (!catalogue_path)
+		return FALSE;
+
+	return CConfig_Registry::Instance().Load_Catalogue(catalogue_path) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_scenarios(uint16_t* config_classes, uint16_t* config_ids, size_t max_count, size_t* count_out)
+{
+	if (!count_out)
+		return FALSE;
+
+	// scgms_game_create takes 16-bit config class and ID, and needs a patient for the scenario
+	std::vector<std::pair<uint32_t, uint32_t>> playable;
+	for (const auto& id : CConfig_Registry::Instance().Get_Scenario_Ids())
+	{
+		if (id.first <= std::numeric_limits<uint16_t>::max() && id.second <= std::numeric_limits<uint16_t>::max()
+			&& Get_Config_Parameters_GUID(id.first, id.second) != Invalid_GUID)
+			playable.push_back(id);
+	}
+
+	*count_out = playable.size();
+
+	// count query
+	if (!config_classes && !config_ids)
+		return TRUE;
+
+	if (!config_classes || !config_ids)
+		return FALSE;
+
+	const size_t count = std::min(max_count, playable.size());
+	for (size_t i = 0; i < count; i++)
+	{
+		config_classes[i] = static_cast<uint16_t>(playable[i].first);
+		config_ids[i] = static_cast<uint16_t>(playable[i].second);
+	}
+
+	return (count == playable.size()) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_load_patient_database(const char* database_path)
+{
+	if (!database_path)
+		return FALSE;
+
+	if (!CPatient_Registry::Instance().Load_Database(database_path))
+		return FALSE;
+
+	// cached configurations may refer to patients, that are now overridden
+	CConfiguration_Cache::Instance().Clear();
+
+	return TRUE;
+}
+
+DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_replay_create_ex(const char* log_file_path, const GUID* signal_ids, uint32_t signal_count, double time_from, double time_to, uint32_t buffer_capacity)
+{
+	if (!log_file_path || (signal_count > 0 && !signal_ids))
+		return nullptr;
+
+	TReplay_Filter filter;
+	filter.signal_ids.assign(signal_ids, signal_ids + signal_count);
+	if (!std::isnan(time_from))
+		filter.time_from = time_from;
+	if (!std::isnan(time_to))
+		filter.time_to = time_to;
+
+	std::unique_ptr<CGame_Wrapper> wrapper = std::make_unique<CGame_Wrapper>(0);
+
+	if (!wrapper->Load_Replay_Configuration(log_file_path, buffer_capacity > 0 ? buffer_capacity : Default_Replay_Buffer_Capacity, filter))
+		return nullptr;
+
+	if (!wrapper->Execute_Configuration())
+		return nullptr;
+
+	auto res = wrapper.get();
+	wrapper.release();
+	return res;
+}
+
+DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_replay_create_buffered(const char* log_file_path, uint32_t buffer_capacity)
+{
+	return scgms_game_replay_create_ex(log_file_path, nullptr, 0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), buffer_capacity);
+}
+
+DLL_EXPORT scgms_game_wrapper_t IfaceCalling scgms_game_replay_create(const char* log_file_path)
+{
+	return scgms_game_replay_create_buffered(log_file_path, 0);
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_step(scgms_game_wrapper_t wrapper_raw, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, double* bg, double* ig, double* iob, double* cob)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	if (input_signal_count > 0 && (!input_signal_ids || !input_signal_levels || !input_signal_times))
+		return FALSE;
+
+	if (!wrapper->Step_With_Inputs(input_signal_ids, input_signal_levels, input_signal_times, input_signal_count))
+		return FALSE;
+
+	Store_State(wrapper->Get_State(), bg, ig, iob, cob);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_fast_forward(scgms_game_wrapper_t wrapper_raw, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count,
+	NGame_Decimation decimation, uint32_t k, double* bg, double* ig, double* iob, double* cob, uint32_t* output_count)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !output_count)
+		return FALSE;
+
+	*output_count = 0;
+
+	if (decimation != NGame_Decimation::Every_Kth_Step && decimation != NGame_Decimation::Window_Min_Max_Mean)
+		return FALSE;
+
+	if (input_signal_count > 0)
+	{
+		if (!input_signal_ids || !input_signal_levels || !input_signal_times)
+			return FALSE;
+
+		if (!std::is_sorted(input_signal_times, input_signal_times + input_signal_count))
+			return FALSE;
+	}
+
+	return wrapper->Fast_Forward(n_steps, input_signal_ids, input_signal_levels, input_signal_times, input_signal_count, decimation, k, bg, ig, iob, cob, *output_count) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_fork(scgms_game_wrapper_t wrapper_raw, uint32_t count, scgms_game_wrapper_t* forks)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !forks || count == 0)
+		return FALSE;
+
+	std::vector<std::unique_ptr<CGame_Wrapper>> created;
+	if (!wrapper->Fork(count, created))
+		return FALSE;
+
+	for (uint32_t i = 0; i < count; i++)
+		forks[i] = created[i].release();
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_evaluate_forks(scgms_game_wrapper_t* forks_raw, uint32_t fork_count, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times,
+	uint32_t* input_fork_offsets, double* bg, double* ig, double* iob, double* cob)
+{
+	if (!forks_raw || fork_count == 0)
+		return FALSE;
+
+	std::vector<CGame_Wrapper*> forks(fork_count);
+	for (uint32_t i = 0; i < fork_count; i++)
+	{
+		forks[i] = dynamic_cast<CGame_Wrapper*>(forks_raw[i]);
+		if (!forks[i])
+			return FALSE;
+	}
+
+	// the same instance cannot be stepped by two workers at once
+	std::vector<CGame_Wrapper*> unique_forks = forks;
+	std::sort(unique_forks.begin(), unique_forks.end());
+	if (std::adjacent_find(unique_forks.begin(), unique_forks.end()) != unique_forks.end())
+		return FALSE;
+
+	if (input_fork_offsets)
+	{
+		if (input_fork_offsets[0] != 0 || !std::is_sorted(input_fork_offsets, input_fork_offsets + fork_count + 1))
+			return FALSE;
+
+		if (input_fork_offsets[fork_count] > 0 && (!input_signal_ids || !input_signal_levels || !input_signal_times))
+			return FALSE;
+
+		for (uint32_t i = 0; i < fork_count; i++)
+		{
+			if (!std::is_sorted(input_signal_times + input_fork_offsets[i], input_signal_times + input_fork_offsets[i + 1]))
+				return FALSE;
+		}
+	}
+
+	return CGame_Wrapper::Evaluate_Forks(forks.data(), fork_count, n_steps, input_signal_ids, input_signal_levels, input_signal_times, input_fork_offsets, bg, ig, iob, cob) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_free_fork(scgms_game_wrapper_t fork_raw)
+{
+	CGame_Wrapper* fork = dynamic_cast<CGame_Wrapper*>(fork_raw);
+	if (!fork || !fork->Is_Fork())
+		return FALSE;
+
+	fork->Terminate(TRUE);
+	delete fork;
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_step_async(scgms_game_wrapper_t wrapper_raw, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, uint64_t* ticket)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !ticket)
+		return FALSE;
+
+	if (input_signal_count > 0 && (!input_signal_ids || !input_signal_levels || !input_signal_times))
+		return FALSE;
+
+	*ticket = wrapper->Step_Async(input_signal_ids, input_signal_levels, input_signal_times, input_signal_count);
+
+	return (*ticket != 0) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_poll_step(scgms_game_wrapper_t wrapper_raw, uint64_t ticket, NGame_Step_State* state, double* bg, double* ig, double* iob, double* cob)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !state)
+		return FALSE;
+
+	CPatient_Sensor_State sensor_state;
+	*state = wrapper->Poll_Step(ticket, sensor_state);
+
+	if (*state == NGame_Step_State::Done)
+		Store_State(sensor_state, bg, ig, iob, cob);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_wait_step(scgms_game_wrapper_t wrapper_raw, uint64_t ticket, uint32_t timeout_ms, NGame_Step_State* state, double* bg, double* ig, double* iob, double* cob)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !state)
+		return FALSE;
+
+	CPatient_Sensor_State sensor_state;
+	*state = wrapper->Wait_Step(ticket, timeout_ms, sensor_state);
+
+	if (*state == NGame_Step_State::Done)
+		Store_State(sensor_state, bg, ig, iob, cob);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_step_n(scgms_game_wrapper_t wrapper_raw, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t* input_step_offsets, double* bg, double* ig, double* iob, double* cob)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	// validate offsets before any step is made, so we don't leave the simulation in the middle of a batch due to malformed inputs
+	if (input_step_offsets)
+	{
+		for (uint32_t i = 0; i < n_steps; i++)
+		{
+			if (input_step_offsets[i + 1] < input_step_offsets[i])
+				return FALSE;
+		}
+
+		if (input_step_offsets[n_steps] > input_step_offsets[0] && (!input_signal_ids || !input_signal_levels || !input_signal_times))
+			return FALSE;
+	}
+
+	return wrapper->Step_N(n_steps, input_signal_ids, input_signal_levels, input_signal_times, input_step_offsets, bg, ig, iob, cob) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_checkpoint(scgms_game_wrapper_t wrapper_raw, uint32_t* checkpoint_id)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !checkpoint_id)
+		return FALSE;
+
+	*checkpoint_id = wrapper->Checkpoint();
+
+	return (*checkpoint_id != 0) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_restore(scgms_game_wrapper_t wrapper_raw, uint32_t checkpoint_id)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return wrapper->Restore(checkpoint_id) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_log_file_path(scgms_game_wrapper_t wrapper_raw, char* buffer, size_t buffer_size)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !buffer)
+		return FALSE;
+
+	const std::string path = wrapper->Get_Log_File_Path();
+	if (path.size() + 1 > buffer_size)
+		return FALSE;
+
+	std::copy(path.begin(), path.end(), buffer);
+	buffer[path.size()] = '\0';
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_replay_step(scgms_game_wrapper_t wrapper_raw, GUID * signal_id, double* level, double* time)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return wrapper->Replay_Step(*signal_id, *level, *time) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_replay_read(scgms_game_wrapper_t wrapper_raw, size_t max_events, GUID* signal_ids, double* levels, double* times, size_t* count_out)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !count_out)
+		return FALSE;
+
+	*count_out = 0;
+
+	if (max_events == 0 || !signal_ids || !levels || !times)
+		return FALSE;
+
+	return wrapper->Replay_Read(max_events, signal_ids, levels, times, *count_out) ? TRUE : FALSE;
+}
+
+namespace
+{
+	// copies up to max_events level events to output arrays; fails if the arrays cannot hold all of them
+	bool Copy_Log_Level_Events(const TLog_Level_Columns& loaded, size_t max_events, GUID* signal_ids, double* levels, double* times, size_t& count_out)
+	{
+		const size_t count = std::min(max_events, loaded.Size());
+		if (count > 0 && (!signal_ids || !levels || !times))
+			return false;
+
+		std::copy(loaded.signal_ids.begin(), loaded.signal_ids.begin() + count, signal_ids);
+		std::copy(loaded.levels.begin(), loaded.levels.begin() + count, levels);
+		std::copy(loaded.device_times.begin(), loaded.device_times.begin() + count, times);
+
+		count_out = count;
+
+		return count == loaded.Size();
+	}
+}
+
+DLL_EXPORT scgms_game_log_t IfaceCalling scgms_game_log_load(const char* log_file_path, size_t* count_out)
+{
+	if (!log_file_path)
+		return nullptr;
+
+	auto loaded = std::make_unique<TLog_Level_Columns>();
+	if (!Load_Log_Level_Events(log_file_path, *loaded))
+		return nullptr;
+
+	if (count_out)
+		*count_out = loaded->Size();
+
+	return loaded.release();
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_log_get_events(scgms_game_log_t log, size_t max_events, GUID* signal_ids, double* levels, double* times, size_t* count_out)
+{
+	if (!log || !count_out)
+		return FALSE;
+
+	*count_out = 0;
+
+	return Copy_Log_Level_Events(*log, max_events, signal_ids, levels, times, *count_out) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_log_free(scgms_game_log_t log)
+{
+	if (!log)
+		return FALSE;
+
+	delete log;
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_replay_seek(scgms_game_wrapper_t wrapper_raw, double rat_time)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || std::isnan(rat_time))
+		return FALSE;
+
+	return wrapper->Replay_Seek(rat_time) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_additional_state(scgms_game_wrapper_t wrapper_raw, GUID * requested_signal_ids, double* output_signal_levels, size_t signal_count)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	if (signal_count > 0 && (!requested_signal_ids || !output_signal_levels))
+		return FALSE;
+
+	return wrapper->Get_Additional_State(requested_signal_ids, output_signal_levels, signal_count) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_startup_profile(scgms_game_wrapper_t wrapper_raw, double* phase_durations_ms, uint32_t phase_count)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper || !phase_durations_ms)
+		return FALSE;
+
+	const auto& profile = wrapper->Get_Startup_Profile();
+
+	const size_t count = std::min(static_cast<size_t>(phase_count), profile.size());
+	std::copy(profile.begin(), profile.begin() + count, phase_durations_ms);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_set_profiling(BOOL enabled)
+{
+	if (enabled != FALSE && !Register_Profiling_Probe())
+		return FALSE;
+
+	Set_Filter_Profiling_Enabled(enabled != FALSE);
+
+	return TRUE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_get_filter_profile(scgms_game_wrapper_t wrapper_raw, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts, uint64_t* total_ns,
+	uint32_t capacity, uint32_t* count_out)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	return Export_Filter_Profile(wrapper->Get_Filter_Profile(), filter_indices, filter_ids, event_counts, total_ns, capacity, count_out) ? TRUE : FALSE;
+}
+
+DLL_EXPORT BOOL IfaceCalling scgms_game_terminate(scgms_game_wrapper_t wrapper_raw)
+{
+	CGame_Wrapper* wrapper = dynamic_cast<CGame_Wrapper*>(wrapper_raw);
+	if (!wrapper)
+		return FALSE;
+
+	wrapper->Terminate(TRUE);
+
+	return TRUE;
+}
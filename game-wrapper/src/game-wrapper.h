@@ -1,242 +1,1025 @@
-/**
- * SmartCGMS - continuous glucose monitoring and controlling framework
- * https://diabetes.zcu.cz/
- *
- * Copyright (c) since 2018 University of West Bohemia.
- *
- * Contact:
- * diabetes@mail.kiv.zcu.cz
- * Medical Informatics, Department of Computer Science and Engineering
- * Faculty of Applied Sciences, University of West Bohemia
- * Univerzitni 8, 301 00 Pilsen
- * Czech Republic
- * 
- * 
- * Purpose of this software:
- * This software is intended to demonstrate work of the diabetes.zcu.cz research
- * group to other scientists, to complement our published papers. It is strictly
- * prohibited to use this software for diagnosis or treatment of any medical condition,
- * without obtaining all required approvals from respective regulatory bodies.
- *
- * Especially, a diabetic patient is warned that unauthorized use of this software
- * may result into severe injure, including death.
- *
- *
- * Licensing terms:
- * Unless required by applicable law or agreed to in writing, software
- * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- *
- * a) This file is available under the Apache License, Version 2.0.
- * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
- *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
- *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
- *    Volume 177, pp. 354-362, 2020
- */
-
-#pragma once
-
-#include <scgms/iface/FilterIface.h>
-#include <scgms/rtl/FilterLib.h>
-#include <scgms/rtl/scgmsLib.h>
-#include <scgms/iface/referencedIface.h>
-#include <scgms/iface/SolverIface.h>
-#include <scgms/rtl/UILib.h>
-#include <scgms/rtl/SolverLib.h>
-
-#include <cstdint>
-#include <cmath>
-#include <limits>
-#include <mutex>
-#include <condition_variable>
-
-// wrapper for sensor state (exported element-wise through interface)
-struct CPatient_Sensor_State
-{
-	double bg = std::numeric_limits<double>::quiet_NaN();
-	double ig = std::numeric_limits<double>::quiet_NaN();
-	double iob = std::numeric_limits<double>::quiet_NaN();
-	double cob = std::numeric_limits<double>::quiet_NaN();
-};
-
-constexpr const GUID game_wrapper_id = { 0xb01f968d, 0x5fb9, 0x426c, { 0x9d, 0x42, 0x67, 0x18, 0xaf, 0xd8, 0xaa, 0xc1 } };	// {B01F968D-5FB9-426C-9D42-6718AFD8AAC1}
-
-#pragma warning( push )
-#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
-
-/*
- * Game wrapper to split back-end logic from front-end
- */
-class CGame_Wrapper : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
-{
-	private:
-		// executor associated with this instance
-		scgms::SFilter_Executor mExecutor;
-		// error list, reused among runs
-		refcnt::Swstr_list mErrors;
-		// loaded config contents
-		std::string mConfig_Contents;
-		// current rat time
-		double mCurrent_Time;
-		// size of a single simulation step
-		double mStep_Size;
-		// used segment ID
-		uint64_t mSegment_Id;
-
-		// mutex for locking sections operating with execution pointer
-		std::mutex mExecution_Mtx;
-
-		// current patient state
-		CPatient_Sensor_State mState;
-
-		// is this a replay run only?
-		bool mIs_Replay = false;
-
-		// stored config ID
-		GUID mConfig_GUID;
-		// stored parameters ID
-		GUID mParameters_GUID;
-
-		// is there a signal pending to be taken by outer code?
-		bool mPending_Signal = false;
-		// ID of pending signal
-		GUID mPending_Replay_Id = Invalid_GUID;
-		// level of pending signal
-		double mPending_Replay_Level = 0;
-		// time of pending signal
-		double mPending_Replay_Time = 0;
-
-		// mutex to synchronize replay with outer code stepping
-		std::mutex mReplay_Step_Mtx;
-		// conditional variable to notify waiters
-		std::condition_variable mReplay_Step_Cv;
-		// has the shut_down event come in replay variant?
-		bool mReplay_Ended = false;
-
-	protected:
-		// inject given event to current execution
-		HRESULT Inject_Event(scgms::UDevice_Event &&event);
-
-		// inject config and params GUID event
-		bool Inject_Configuration_Info();
-
-	public:
-		CGame_Wrapper(uint32_t stepping_ms);
-		virtual ~CGame_Wrapper();
-
-		// load regular gameplay configuration
-		bool Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_path);
-		// load replay configuration (just log replay filter)
-		bool Load_Replay_Configuration(const std::string& log_file_src_path);
-
-		// execute the configuration (create executor and start segments, ...); common for regular gameplay and for replays
-		bool Execute_Configuration();
-
-		// step the model; just for regular gameplay
-		bool Step(bool initial = false);
-		// step the replay; just for replays
-		bool Replay_Step(GUID& id, double& level, double& time);
-
-		// terminate the execution; common for regular gameplay and for replays
-		void Terminate(const BOOL wait_for_shutdown);
-
-		// inject level to the chain; valid for regular gameplay only
-		bool Inject_Level(GUID* signal_id, double level, double relative_step_time);
-
-		// retrieve the sensor state
-		const CPatient_Sensor_State& Get_State() const;
-
-		// scgms::IFilter iface
-		virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description);
-		virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event);
-};
-
-// a type for interop-exportable pointer to CGame_Wrapper instance; the pointer should never be dereferenced in outer code as the CGame_Wrapper class is not designed to be interoperable
-using scgms_game_wrapper_t = CGame_Wrapper*;
-
-/*
- * scgms_game_create
- *
- * Creates game wrapper instance with given parameters.
- *
- * Parameters:
- *		config_class - category of configs to be used; this is more like an attept to split difficulties and patient types
- *		config_id - config identifier within selected config class
- *		stepping_ms - model stepping in milliseconds - subsequent scgms_game_step calls would step the model by this exact amount of milliseconds
- *		log_file_path - where to put the log file; empty or nullptr to indicate the intent to discard the log
- *
- * Return values:
- *		<valid scgms_game_wrapper_t> - success
- *		nullptr - failure
- */
-extern "C" scgms_game_wrapper_t IfaceCalling scgms_game_create(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_path);
-
-/*
- * scgms_game_step
- *
- * Performs a single step within the simulation, injects all necessary events according to given parameters
- *
- * Parameters:
- *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
- *		input_signal_ids - array of signal GUIDs
- *		input_signal_levels - array of levels
- *		input_signal_times - array of times; times are a relative factor of step, range <0;1)
- *		input_signal_count - count of input signal arrays (input_signal_ids, input_signal_levels, input_signal_times)
- *		bg - output variable for blood glucose reading [mmol/L]
- *		ig - output variable for interstitial glucose reading [mmol/L]
- *		iob - output variable for current model insulin on board [U]
- *		cob - output variable for current model carbohydrates on board [g]
- *
- * Return values:
- *		TRUE (non-zero) - success
- *		FALSE (zero) - failure - parameters are invalid or the attempt to step the model has failed
- */
-extern "C" BOOL IfaceCalling scgms_game_step(scgms_game_wrapper_t wrapper, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, double* bg, double* ig, double* iob, double* cob);
-
-/*
- * scgms_game_replay_step
- *
- * Performs a single step during replay; retains a single event during it - this does not correspond to a time-based stepping, but rather level-based
- *
- * Parameters:
- *		wrapper - pointer to a game wrapper instance obtained from scgms_game_replay_create call
- *		signal_id - pointer to a memory, where the id of obtained signal is stored
- *		level - pointer to a memory, where the signal level is stored
- *		time - pointer to a memory, where the timestamp is stored
- *
- * Return values:
- *		TRUE (non-zero) - success
- *		FALSE (zero) - the simulation ended (no more events will come)
- */
-extern "C" BOOL IfaceCalling scgms_game_replay_step(scgms_game_wrapper_t wrapper, GUID* signal_id, double* level, double* time);
-
-/*
- * scgms_game_get_additional_state
- *
- * Retrieves an additional state info from the game wrapper; the game should be running (wrapper points to a valid object)
- *
- * Parameters:
- *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
- *		requested_signal_ids - pointer to an array of requested signal IDs
- *		output_signal_levels - a pointer to an array, which will be filled by requested signal levels
- *		signal_count - count of requested signal IDs and the output array
- *
- * Return values:
- *		TRUE (non-zero) - success
- *		FALSE (zero) - failure - at least one of the requested state signals were not found
- */
-extern "C" BOOL IfaceCalling scgms_game_get_additional_state(scgms_game_wrapper_t wrapper, GUID* requested_signal_ids, double* output_signal_levels, size_t signal_count);
-
-/*
- * scgms_game_terminate
- *
- * Terminates the running game, invalidates the obtained scgms_game_wrapper_t object. May block due to yet unprocessed events.
- *
- * Parameters:
- *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
- *
- * Return values:
- *		TRUE (non-zero) - success
- *		FALSE (zero) - failure
- */
-extern "C" BOOL IfaceCalling scgms_game_terminate(scgms_game_wrapper_t wrapper);
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/scgmsLib.h>
+#include <scgms/iface/referencedIface.h>
+#include <scgms/iface/SolverIface.h>
+#include <scgms/rtl/UILib.h>
+#include <scgms/rtl/SolverLib.h>
+
+#include "signal-state-table.h"
+#include "spsc-ring.h"
+#include "binary-log.h"
+#include "config-cache.h"
+#include "filter-profiler.h"
+#include "log-loader.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// wrapper for sensor state (exported element-wise through interface)
+struct CPatient_Sensor_State
+{
+	double bg = std::numeric_limits<double>::quiet_NaN();
+	double ig = std::numeric_limits<double>::quiet_NaN();
+	double iob = std::numeric_limits<double>::quiet_NaN();
+	double cob = std::numeric_limits<double>::quiet_NaN();
+};
+
+// state of an asynchronously requested step
+enum class NGame_Step_State : uint32_t
+{
+	Pending		= 0,	// the step is queued or being simulated
+	Done		= 1,	// the step has been simulated, outputs are valid
+	Failed		= 2,	// the attempt to step the model has failed
+	Unknown		= 3,	// the ticket was never issued, its result has already been retrieved, or it has been dropped as too old
+
+	count
+};
+
+// output decimation of fast-forward simulation
+enum class NGame_Decimation : uint32_t
+{
+	Every_Kth_Step		= 0,	// state after every k-th step is stored; one value per output sample
+	Window_Min_Max_Mean	= 1,	// minimum, maximum and mean of each window of k steps is stored; three values per output sample
+
+	count
+};
+
+// phases of the session start-up; durations are reported by scgms_game_get_startup_profile in this order
+enum class NStartup_Phase : uint32_t
+{
+	Config_Build	= 0,	// expansion of the config template; zero if the parsed configuration was taken from the cache
+	Config_Parse	= 1,	// parsing of the expanded configuration; zero if the parsed configuration was taken from the cache
+	Chain_Create	= 2,	// creation of the filter executor (filter discovery, model initialization, ...)
+	Segment_Start	= 3,	// injection of the time segment start event
+	Initial_Step	= 4,	// the initial step, which emits the initial state
+	Total			= 5,	// from the creation of the wrapper instance to the end of the initial step
+
+	count
+};
+
+// wait timeout, that never expires
+constexpr uint32_t Infinite_Wait_Timeout = std::numeric_limits<uint32_t>::max();
+
+// a single level event passed from the replayed chain to the outer code
+struct TReplay_Event
+{
+	GUID signal_id = Invalid_GUID;
+	double level = 0;
+	double device_time = 0;
+};
+
+// selection of replayed level events; events not selected are dropped before they are passed to the outer code
+struct TReplay_Filter
+{
+	// selected signals; empty to select all signals
+	std::vector<GUID> signal_ids;
+	// selected time range, inclusive
+	double time_from = -std::numeric_limits<double>::infinity();
+	double time_to = std::numeric_limits<double>::infinity();
+
+	bool Accepts(const GUID& signal_id, double device_time) const
+	{
+		if (device_time < time_from || device_time > time_to)
+			return false;
+
+		// consumers typically select just a few signals, so linear search is the fastest here
+		return signal_ids.empty() || std::find(signal_ids.begin(), signal_ids.end(), signal_id) != signal_ids.end();
+	}
+};
+
+// default count of replay events, that may be buffered before the log replay gets blocked
+constexpr size_t Default_Replay_Buffer_Capacity = 4096;
+
+// count of most recently completed async steps, whose results are kept until retrieved; results of older steps are dropped
+constexpr uint64_t Max_Async_Result_Count = 1024;
+
+// maximum count of checkpoints kept for a single session; the oldest one is discarded when exceeded
+constexpr size_t Max_Checkpoint_Count = 8;
+
+// an event injected into the simulation chain; the journal of these allows to bring another chain to the same state
+// consecutive synchronization steps are journaled as a single entry, that repeats the event repeat_count times, repeat_step apart
+struct TJournal_Entry
+{
+	scgms::NDevice_Event_Code event_code;
+	GUID signal_id;
+	double level;
+	double device_time;
+	uint64_t segment_id;
+	uint32_t repeat_count;
+	double repeat_step;
+};
+
+constexpr const GUID game_wrapper_id = { 0xb01f968d, 0x5fb9, 0x426c, { 0x9d, 0x42, 0x67, 0x18, 0xaf, 0xd8, 0xaa, 0xc1 } };	// {B01F968D-5FB9-426C-9D42-6718AFD8AAC1}
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Terminal filter of a simulation chain, which forwards events to its target; allows to detach the chain from the game wrapper,
+ * e.g.; when the chain is being prepared in the background, or when it is being replaced by another chain
+ */
+class CChain_Output_Gate : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
+{
+	private:
+		std::atomic<scgms::IFilter*> mTarget;
+		// binary log of the chain, if any; unlike the CSV log, the binary one is not written by a filter of the chain
+		std::unique_ptr<CBinary_Log_Writer> mLog;
+
+	public:
+		CChain_Output_Gate(scgms::IFilter* target, std::unique_ptr<CBinary_Log_Writer> log = nullptr) : mTarget(target), mLog(std::move(log)) { }
+		virtual ~CChain_Output_Gate() = default;
+
+		// sets the target of events; nullptr discards all events
+		void Set_Target(scgms::IFilter* target)
+		{
+			mTarget.store(target, std::memory_order_release);
+		}
+
+		// scgms::IFilter iface
+		virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description)
+		{
+			return E_NOTIMPL;
+		}
+
+		virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event)
+		{
+			// UDevice_Event destructor releases the event for us, unless it is passed further
+			scgms::UDevice_Event evt{ event };
+
+			if (mLog)
+				mLog->Write(evt);
+
+			scgms::IFilter* target = mTarget.load(std::memory_order_acquire);
+			if (!target)
+				return S_OK;
+
+			scgms::IDevice_Event* raw_event = evt.get();
+			evt.release();
+			return target->Execute(raw_event);
+		}
+};
+
+/*
+ * Game wrapper to split back-end logic from front-end
+ */
+class CGame_Wrapper : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
+{
+	private:
+		// executor associated with this instance
+		scgms::SFilter_Executor mExecutor;
+		// output gate of the executed chain, forwards events to this instance
+		std::unique_ptr<CChain_Output_Gate> mOutput_Gate;
+		// error list, reused among runs
+		refcnt::Swstr_list mErrors;
+		// loaded configuration; shared with other sessions of the same parameters
+		std::shared_ptr<TParsed_Configuration> mConfiguration;
+		// per-filter profile; just for sessions created while the profiling was enabled
+		std::shared_ptr<CFilter_Profile> mFilter_Profile;
+		// current rat time
+		double mCurrent_Time;
+		// size of a single simulation step
+		double mStep_Size;
+		// used segment ID
+		uint64_t mSegment_Id;
+
+		// mutex for locking sections operating with execution pointer
+		std::mutex mExecution_Mtx;
+
+		// when the instance was created; start of the total start-up time
+		std::chrono::steady_clock::time_point mCreation_Time = std::chrono::steady_clock::now();
+		// durations of start-up phases in milliseconds, indexed by NStartup_Phase
+		std::array<double, static_cast<size_t>(NStartup_Phase::count)> mStartup_Profile{};
+
+		// current patient state
+		CPatient_Sensor_State mState;
+
+		// slots of signals exported through CPatient_Sensor_State; always registered first, in this order
+		enum NState_Slot : size_t
+		{
+			Slot_BG = 0,
+			Slot_IG,
+			Slot_IOB,
+			Slot_COB,
+
+			Primary_Slot_Count
+		};
+
+		// last known levels of all signals seen in the current configuration
+		CSignal_State_Table mSignal_States;
+
+		// is this a replay run only?
+		bool mIs_Replay = false;
+		// is this a copy created by Fork? forks are owned by the outer code, that releases them with scgms_game_free_fork
+		bool mIs_Fork = false;
+
+		// stored config ID
+		GUID mConfig_GUID;
+		// stored parameters ID
+		GUID mParameters_GUID;
+		// path to the log file written by the chain; empty if not logging
+		std::string mLog_File_Path;
+
+		// all events injected to the chain since the configuration was executed (regular gameplay only)
+		std::vector<TJournal_Entry> mJournal;
+		// may the next synchronization step extend the last journal entry?
+		bool mJournal_Run_Open = false;
+		// device time of the last event journaled by the last entry
+		double mJournal_Last_Time = 0;
+
+		// a captured simulation state; the chain state is not captured, it is reproduced from the journal prefix once the checkpoint gets restored
+		struct TCheckpoint
+		{
+			uint32_t id = 0;
+			double current_time = 0;
+			CPatient_Sensor_State state;
+			CSignal_State_Table signal_states;
+			size_t journal_length = 0;
+		};
+
+		// recent checkpoints, the oldest first
+		std::deque<TCheckpoint> mCheckpoints;
+		// ID to be assigned to the next checkpoint
+		uint32_t mNext_Checkpoint_Id = 1;
+
+		// events produced by the replayed chain, waiting to be taken by outer code; closed on shut down
+		std::unique_ptr<CSPSC_Ring<TReplay_Event>> mReplay_Events;
+		// path to the replayed log
+		std::string mReplay_Log_Path;
+		// selection of replayed events
+		TReplay_Filter mReplay_Filter;
+		// replayed binary log; binary logs are replayed without any chain
+		std::unique_ptr<CBinary_Log_Reader> mBinary_Replay;
+		// level events of a CSV log, loaded on the first seek; the log is then replayed from memory
+		std::vector<TBinary_Log_Record> mReplay_Records;
+		CLog_Time_Index mReplay_Records_Index;
+		// thread passing records of a binary log, or loaded records of a CSV log to the replay buffer
+		std::thread mRecord_Replay_Thread;
+
+		// reused buffer for ordering step inputs by their relative time
+		std::vector<uint32_t> mInput_Order;
+
+		// a step request queued for the simulation thread
+		struct TAsync_Step_Command
+		{
+			uint64_t ticket = 0;
+			std::vector<GUID> signal_ids;
+			std::vector<double> levels;
+			std::vector<double> relative_times;
+		};
+
+		// result of a step performed by the simulation thread
+		struct TAsync_Step_Result
+		{
+			bool succeeded = false;
+			CPatient_Sensor_State state;
+		};
+
+		// simulation thread processing asynchronous step requests; started on the first request
+		std::unique_ptr<std::thread> mSimulation_Thread;
+		// mutex guarding the command queue and the results
+		std::mutex mAsync_Mtx;
+		// notifies the simulation thread about new commands
+		std::condition_variable mAsync_Command_Cv;
+		// notifies waiters about completed steps
+		std::condition_variable mAsync_Result_Cv;
+		// steps waiting to be simulated
+		std::deque<TAsync_Step_Command> mAsync_Commands;
+		// results of simulated steps, until they are retrieved or fall out of the Max_Async_Result_Count window
+		std::unordered_map<uint64_t, TAsync_Step_Result> mAsync_Results;
+		// ticket to be assigned to the next request
+		uint64_t mNext_Ticket = 1;
+		// ticket of the last simulated step; tickets are processed in order
+		uint64_t mLast_Completed_Ticket = 0;
+		// should the simulation thread stop after processing queued commands?
+		bool mAsync_Stop = false;
+
+	protected:
+		// inject given event to current execution
+		HRESULT Inject_Event(scgms::UDevice_Event &&event);
+		// appends given event to the journal, or extends the last entry, if the event just continues its run of synchronization steps
+		void Journal_Event(const scgms::UDevice_Event& event);
+
+		// step the model; the caller must hold the execution mutex
+		bool Step_Unlocked(bool initial);
+		// inject level to the chain; the caller must hold the execution mutex
+		bool Inject_Level_Unlocked(const GUID& signal_id, double level, double relative_step_time);
+		// inject inputs ordered by their relative time and step the model; the caller must hold the execution mutex
+		bool Step_With_Inputs_Unlocked(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count);
+
+		// inject config and params GUID event
+		bool Inject_Configuration_Info();
+
+		// resets signal state table and registers primary signals and all signals produced by the loaded configuration
+		void Build_Signal_State_Table();
+
+		// creates executor of given configuration, logging to given log file; the chain outputs to the gate, that forwards events to the target
+		// and writes the log, if it is binary
+		// probes of a profiled configuration are attached to given profile
+		static bool Create_Chain(TParsed_Configuration& configuration, const std::string& log_file_path, scgms::IFilter* target, refcnt::Swstr_list& errors,
+			scgms::SFilter_Executor& executor, std::unique_ptr<CChain_Output_Gate>& gate, const std::shared_ptr<CFilter_Profile>& profile = nullptr);
+		// record replay thread function; passes level records to the replay buffer
+		void Record_Replay_Thread_Fnc(const TBinary_Log_Record* begin, const TBinary_Log_Record* end);
+		// stops the record replay thread, if running
+		void Stop_Record_Replay();
+		// terminates given chain; stop_segment indicates, that the current time segment should be properly ended
+		static void Shut_Down_Chain(scgms::SFilter_Executor& executor, double current_time, uint64_t segment_id, bool stop_segment, const BOOL wait_for_shutdown);
+
+		// replaces the chain with a new one, that re-simulates first journal_length journal entries; the caller must hold the execution mutex
+		// the new chain rewrites the session log, so the current chain is shut down first; the session has no chain, if this fails
+		bool Rebuild_Chain_Unlocked(size_t journal_length);
+
+		// simulation thread function; performs queued asynchronous steps
+		void Simulation_Thread_Fnc();
+		// stops the simulation thread after all queued steps are performed
+		void Stop_Simulation_Thread();
+		// retrieves the result of given ticket; the caller must hold the async mutex
+		NGame_Step_State Take_Async_Result(uint64_t ticket, CPatient_Sensor_State& state);
+
+	public:
+		CGame_Wrapper(uint32_t stepping_ms);
+		virtual ~CGame_Wrapper();
+
+		// load regular gameplay configuration
+		bool Load_Configuration(uint16_t config_class, uint16_t config_id, const std::string& log_file_path);
+		// load replay configuration (just log replay filter); buffer_capacity is a count of events the log replay may read ahead of the outer code
+		bool Load_Replay_Configuration(const std::string& log_file_src_path, size_t buffer_capacity = Default_Replay_Buffer_Capacity, const TReplay_Filter& filter = {});
+
+		// execute the configuration (create executor and start segments, ...); common for regular gameplay and for replays
+		bool Execute_Configuration();
+
+		// step the model; just for regular gameplay
+		bool Step(bool initial = false);
+		// retrieve durations of start-up phases in milliseconds, indexed by NStartup_Phase
+		const std::array<double, static_cast<size_t>(NStartup_Phase::count)>& Get_Startup_Profile() const;
+		// retrieve per-filter profile; nullptr if the session is not profiled
+		const CFilter_Profile* Get_Filter_Profile() const;
+		// inject given inputs (in the order of their relative times) and step the model; just for regular gameplay
+		bool Step_With_Inputs(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count);
+		// perform n_steps consecutive steps; inputs of i-th step are stored at indices <input_offsets[i]; input_offsets[i+1]) of input arrays
+		bool Step_N(uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* relative_times, const uint32_t* input_offsets,
+			double* bg, double* ig, double* iob, double* cob);
+		// perform n_steps steps with inputs given by a time-sorted schedule (times in steps, relative to current time) and store decimated outputs; just for regular gameplay
+		bool Fast_Forward(uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* times, uint32_t count,
+			NGame_Decimation decimation, uint32_t k, double* bg, double* ig, double* iob, double* cob, uint32_t& output_count);
+		// queue a step with given inputs to be performed by the simulation thread; returns ticket of the step, or 0 on failure; just for regular gameplay
+		uint64_t Step_Async(const GUID* signal_ids, const double* levels, const double* relative_times, uint32_t count);
+		// retrieve the state of an asynchronous step; the result is released once it is reported as done or failed
+		NGame_Step_State Poll_Step(uint64_t ticket, CPatient_Sensor_State& state);
+		// wait for an asynchronous step to be performed, at most timeout_ms milliseconds; the result is released once it is reported as done or failed
+		NGame_Step_State Wait_Step(uint64_t ticket, uint32_t timeout_ms, CPatient_Sensor_State& state);
+		// wait until all queued asynchronous steps are performed
+		void Wait_Async_Idle();
+
+		// capture the current simulation state; returns checkpoint ID, or 0 on failure; just for regular gameplay
+		uint32_t Checkpoint();
+		// return the simulation to given checkpoint; checkpoints created after it are discarded; just for regular gameplay
+		bool Restore(uint32_t checkpoint_id);
+		// retrieve the path of log file written by the simulation
+		std::string Get_Log_File_Path() const;
+
+		// create count headless (non-logging) copies of the current simulation state; just for regular gameplay
+		bool Fork(uint32_t count, std::vector<std::unique_ptr<CGame_Wrapper>>& forks);
+		// fast-forward all given forks in parallel, each with its own input schedule; stores n_steps outputs per fork
+		static bool Evaluate_Forks(CGame_Wrapper* const* forks, uint32_t fork_count, uint32_t n_steps, const GUID* signal_ids, const double* levels, const double* times,
+			const uint32_t* input_fork_offsets, double* bg, double* ig, double* iob, double* cob);
+		// was this instance created by Fork?
+		bool Is_Fork() const;
+
+		// step the replay; just for replays
+		bool Replay_Step(GUID& id, double& level, double& time);
+		// take up to max_events buffered replay events at once; blocks until at least one event is available; just for replays
+		bool Replay_Read(size_t max_events, GUID* ids, double* levels, double* times, size_t& count);
+		// restart the replay from the first event at or after given time; must not be called concurrently with Replay_Step or Replay_Read; just for replays
+		bool Replay_Seek(double time);
+
+		// terminate the execution; common for regular gameplay and for replays
+		void Terminate(const BOOL wait_for_shutdown);
+
+		// inject level to the chain; valid for regular gameplay only
+		bool Inject_Level(GUID* signal_id, double level, double relative_step_time);
+
+		// retrieve the sensor state
+		const CPatient_Sensor_State& Get_State() const;
+		// retrieve last known levels of given signals; returns false, if at least one of them has not been seen yet (its level is set to NaN)
+		bool Get_Additional_State(const GUID* signal_ids, double* levels, size_t count);
+
+		// scgms::IFilter iface
+		virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description);
+		virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event);
+};
+
+// a type for interop-exportable pointer to CGame_Wrapper instance; the pointer should never be dereferenced in outer code as the CGame_Wrapper class is not designed to be interoperable
+using scgms_game_wrapper_t = CGame_Wrapper*;
+
+/*
+ * scgms_game_create
+ *
+ * Creates game wrapper instance with given parameters.
+ *
+ * Parameters:
+ *		config_class - category of configs to be used; this is more like an attept to split difficulties and patient types
+ *		config_id - config identifier within selected config class
+ *		stepping_ms - model stepping in milliseconds - subsequent scgms_game_step calls would step the model by this exact amount of milliseconds
+ *		log_file_path - where to put the log file; empty or nullptr to indicate the intent to discard the log; the .sbl extension selects the compact binary format instead of CSV
+ *
+ * Return values:
+ *		<valid scgms_game_wrapper_t> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_wrapper_t IfaceCalling scgms_game_create(uint16_t config_class, uint16_t config_id, uint32_t stepping_ms, const char* log_file_path);
+
+/*
+ * scgms_game_load_catalogue
+ *
+ * Loads a scenario catalogue, or all catalogues (.catalogue files) in a directory; see config-registry.h for the catalogue format
+ * Catalogue scenarios are then selectable by config class and config ID in scgms_game_create; templates are read from their files on first use
+ *
+ * Parameters:
+ *		catalogue_path - path to a catalogue file, or to a directory with catalogue files
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure, at least one catalogue could not be read or contains an invalid declaration (such catalogue is not loaded at all)
+ */
+extern "C" BOOL IfaceCalling scgms_game_load_catalogue(const char* catalogue_path);
+
+/*
+ * scgms_game_get_scenarios
+ *
+ * Lists scenarios selectable in scgms_game_create, i.e.; built-in ones and those of loaded catalogues, that have a known patient
+ * A scenario applying to all config IDs of its class is listed with config ID 1 only
+ * If both output arrays are nullptr, just the count of scenarios is retrieved; if the output arrays are too small, they are filled up to their capacity and the call fails
+ *
+ * Parameters:
+ *		config_classes - output array of config classes
+ *		config_ids - output array of config IDs
+ *		max_count - capacity of output arrays
+ *		count_out - pointer to a memory, where the count of all scenarios is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, all scenarios have been stored
+ *		FALSE (zero) - failure, invalid parameters, or the output arrays are too small
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_scenarios(uint16_t* config_classes, uint16_t* config_ids, size_t max_count, size_t* count_out);
+
+/*
+ * scgms_game_load_patient_database
+ *
+ * Loads a binary virtual patient database (.spdb); its patients are then selectable by config class and config ID in scgms_game_create
+ * Patients of later loaded databases take precedence over patients of earlier ones and over built-in patients
+ *
+ * Parameters:
+ *		database_path - path to the patient database file
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure, the file could not be mapped or is not a valid patient database
+ */
+extern "C" BOOL IfaceCalling scgms_game_load_patient_database(const char* database_path);
+
+/*
+ * scgms_game_replay_create
+ *
+ * Creates game wrapper instance, that replays given log file
+ *
+ * Parameters:
+ *		log_file_path - path to a log file to be replayed; either CSV, or binary (.sbl)
+ *
+ * Return values:
+ *		<valid scgms_game_wrapper_t> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_wrapper_t IfaceCalling scgms_game_replay_create(const char* log_file_path);
+
+/*
+ * scgms_game_replay_create_buffered
+ *
+ * Creates game wrapper instance, that replays given log file; allows to specify how far the log replay may run ahead of the outer code
+ *
+ * Parameters:
+ *		log_file_path - path to a log file to be replayed; either CSV, or binary (.sbl)
+ *		buffer_capacity - count of events, that may be buffered before the log replay blocks; rounded up to a power of two; 0 to use the default capacity
+ *
+ * Return values:
+ *		<valid scgms_game_wrapper_t> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_wrapper_t IfaceCalling scgms_game_replay_create_buffered(const char* log_file_path, uint32_t buffer_capacity);
+
+/*
+ * scgms_game_replay_create_ex
+ *
+ * Creates game wrapper instance, that replays just selected signals within given time range of given log file
+ * Events not selected are never buffered nor passed to the outer code
+ * Binary logs are read by the wrapper itself, which seeks to the start of the time range and skips events not selected without decoding them
+ * CSV logs are read by the SmartCGMS log replay filter, which has no signal nor time selection; the whole log is still parsed and
+ * the events are selected only as they leave the chain, so the selection does not make CSV replays any faster
+ *
+ * Parameters:
+ *		log_file_path - path to a log file to be replayed; either CSV, or binary (.sbl)
+ *		signal_ids - array of signal GUIDs to be replayed; may be nullptr, if signal_count is zero
+ *		signal_count - count of signal GUIDs; 0 to replay all signals
+ *		time_from - time of the first replayed event (inclusive), as a rat time; NaN for no lower bound
+ *		time_to - time of the last replayed event (inclusive), as a rat time; NaN for no upper bound
+ *		buffer_capacity - count of events, that may be buffered before the log replay blocks; rounded up to a power of two; 0 to use the default capacity
+ *
+ * Return values:
+ *		<valid scgms_game_wrapper_t> - success
+ *		nullptr - failure
+ */
+extern "C" scgms_game_wrapper_t IfaceCalling scgms_game_replay_create_ex(const char* log_file_path, const GUID* signal_ids, uint32_t signal_count, double time_from, double time_to, uint32_t buffer_capacity);
+
+/*
+ * scgms_game_step
+ *
+ * Performs a single step within the simulation, injects all necessary events according to given parameters
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		input_signal_ids - array of signal GUIDs
+ *		input_signal_levels - array of levels
+ *		input_signal_times - array of times; times are a relative factor of step, range <0;1)
+ *		input_signal_count - count of input signal arrays (input_signal_ids, input_signal_levels, input_signal_times)
+ *		bg - output variable for blood glucose reading [mmol/L]
+ *		ig - output variable for interstitial glucose reading [mmol/L]
+ *		iob - output variable for current model insulin on board [U]
+ *		cob - output variable for current model carbohydrates on board [g]
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid or the attempt to step the model has failed
+ */
+extern "C" BOOL IfaceCalling scgms_game_step(scgms_game_wrapper_t wrapper, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, double* bg, double* ig, double* iob, double* cob);
+
+/*
+ * scgms_game_step_n
+ *
+ * Performs n_steps consecutive steps within the simulation in a single call; equivalent to n_steps calls of scgms_game_step
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		n_steps - number of steps to be performed
+ *		input_signal_ids - array of signal GUIDs of all steps
+ *		input_signal_levels - array of levels of all steps
+ *		input_signal_times - array of times of all steps; times are a relative factor of their step, range <0;1)
+ *		input_step_offsets - array of n_steps + 1 offsets; inputs of i-th step are stored at indices <input_step_offsets[i]; input_step_offsets[i+1]) of input arrays;
+ *		                     may be nullptr, if no inputs are to be injected
+ *		bg - output array of n_steps blood glucose readings [mmol/L]; may be nullptr
+ *		ig - output array of n_steps interstitial glucose readings [mmol/L]; may be nullptr
+ *		iob - output array of n_steps model insulin on board values [U]; may be nullptr
+ *		cob - output array of n_steps model carbohydrates on board values [g]; may be nullptr
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid or the attempt to step the model has failed; outputs of already performed steps are filled
+ */
+extern "C" BOOL IfaceCalling scgms_game_step_n(scgms_game_wrapper_t wrapper, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t* input_step_offsets, double* bg, double* ig, double* iob, double* cob);
+
+/*
+ * scgms_game_fast_forward
+ *
+ * Performs n_steps steps within the simulation at maximum speed, injecting inputs of given schedule, and stores just decimated outputs
+ * Intended for scripted long-horizon simulations; to avoid logging overhead, create the game wrapper instance with an empty log file path
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		n_steps - total duration of the simulation in steps
+ *		input_signal_ids - array of signal GUIDs of the schedule
+ *		input_signal_levels - array of levels of the schedule
+ *		input_signal_times - array of non-decreasing times of the schedule, in steps relative to the current simulation time; e.g., 12.5 means
+ *		                     the middle of the 13th step; inputs scheduled at or after n_steps are not injected
+ *		input_signal_count - count of scheduled inputs
+ *		decimation - how to decimate outputs
+ *		k - decimation factor; with Every_Kth_Step, n_steps / k samples are stored; with Window_Min_Max_Mean, ceil(n_steps / k) windows are stored,
+ *		    each as three consecutive values - minimum, maximum and mean (NaN levels are skipped)
+ *		bg - output array for decimated blood glucose [mmol/L]; may be nullptr
+ *		ig - output array for decimated interstitial glucose [mmol/L]; may be nullptr
+ *		iob - output array for decimated model insulin on board [U]; may be nullptr
+ *		cob - output array for decimated model carbohydrates on board [g]; may be nullptr
+ *		output_count - output variable for the count of stored samples (windows)
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid (e.g.; the schedule is not sorted) or the attempt to step the model has failed
+ */
+extern "C" BOOL IfaceCalling scgms_game_fast_forward(scgms_game_wrapper_t wrapper, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count,
+	NGame_Decimation decimation, uint32_t k, double* bg, double* ig, double* iob, double* cob, uint32_t* output_count);
+
+/*
+ * scgms_game_fork
+ *
+ * Creates count independent copies of a running game; the copies continue from the current simulation state, but do not write any log
+ * Intended for what-if evaluations (e.g.; comparing candidate boluses) without affecting the original game
+ * Filters do not expose their internal state, so a simulation chain cannot be copied; each copy reaches the current state by re-simulating the whole
+ * session history in its own chain instead (copies are created in parallel), so the cost grows with both the history length and count
+ * The history is journaled in memory, consecutive steps without inputs take a single entry
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		count - count of copies to be created
+ *		forks - output array of count game wrapper instances; each must be released with scgms_game_free_fork call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid or the copies could not be created; no copies are returned in such case
+ */
+extern "C" BOOL IfaceCalling scgms_game_fork(scgms_game_wrapper_t wrapper, uint32_t count, scgms_game_wrapper_t* forks);
+
+/*
+ * scgms_game_evaluate_forks
+ *
+ * Advances all given game wrapper instances (typically obtained from scgms_game_fork call) by n_steps steps in parallel, each with its own input schedule
+ * Equivalent to calling scgms_game_fast_forward with decimation Every_Kth_Step and k = 1 on each instance
+ *
+ * Parameters:
+ *		forks - array of game wrapper instances; each instance must be present just once
+ *		fork_count - count of instances
+ *		n_steps - count of steps to be performed by each instance
+ *		input_signal_ids - array of signal GUIDs of all schedules
+ *		input_signal_levels - array of levels of all schedules
+ *		input_signal_times - array of times of all schedules; times of each schedule are non-decreasing, in steps relative to the current simulation time
+ *		input_fork_offsets - array of fork_count + 1 offsets; schedule of i-th instance is stored at indices <input_fork_offsets[i]; input_fork_offsets[i+1]) of input arrays;
+ *		                     may be nullptr, if no inputs are to be injected
+ *		bg - output array of fork_count * n_steps blood glucose readings [mmol/L]; outputs of i-th instance start at index i * n_steps; may be nullptr
+ *		ig - output array of fork_count * n_steps interstitial glucose readings [mmol/L]; laid out like bg; may be nullptr
+ *		iob - output array of fork_count * n_steps model insulin on board values [U]; laid out like bg; may be nullptr
+ *		cob - output array of fork_count * n_steps model carbohydrates on board values [g]; laid out like bg; may be nullptr
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid or the attempt to step any of the instances has failed
+ */
+extern "C" BOOL IfaceCalling scgms_game_evaluate_forks(scgms_game_wrapper_t* forks, uint32_t fork_count, uint32_t n_steps, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times,
+	uint32_t* input_fork_offsets, double* bg, double* ig, double* iob, double* cob);
+
+/*
+ * scgms_game_free_fork
+ *
+ * Terminates a game wrapper instance obtained from scgms_game_fork call and releases it; the instance must not be used anymore after this call
+ *
+ * Parameters:
+ *		fork - game wrapper instance obtained from scgms_game_fork call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - the instance was not obtained from scgms_game_fork call
+ */
+extern "C" BOOL IfaceCalling scgms_game_free_fork(scgms_game_wrapper_t fork);
+
+/*
+ * scgms_game_step_async
+ *
+ * Queues a single step within the simulation to be performed by the session's simulation thread; returns immediatelly
+ * Steps are performed in the order they were queued; synchronous calls made on the same instance wait until all queued steps are performed
+ * Only results of the last Max_Async_Result_Count completed steps are kept; older results, that were not retrieved, are dropped and their tickets report Unknown
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		input_signal_ids - array of signal GUIDs
+ *		input_signal_levels - array of levels
+ *		input_signal_times - array of times; times are a relative factor of step, range <0;1)
+ *		input_signal_count - count of input signal arrays (input_signal_ids, input_signal_levels, input_signal_times)
+ *		ticket - output variable for the step ticket, used to retrieve the step result
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, the step has been queued
+ *		FALSE (zero) - failure - parameters are invalid
+ */
+extern "C" BOOL IfaceCalling scgms_game_step_async(scgms_game_wrapper_t wrapper, GUID* input_signal_ids, double* input_signal_levels, double* input_signal_times, uint32_t input_signal_count, uint64_t* ticket);
+
+/*
+ * scgms_game_poll_step
+ *
+ * Retrieves the state of a step queued by scgms_game_step_async; does not block
+ * Once the step is reported as done or failed, its result is released and the ticket becomes unknown
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		ticket - ticket obtained from scgms_game_step_async call
+ *		state - output variable for the step state
+ *		bg - output variable for blood glucose reading [mmol/L]; valid only if the step is done
+ *		ig - output variable for interstitial glucose reading [mmol/L]; valid only if the step is done
+ *		iob - output variable for current model insulin on board [U]; valid only if the step is done
+ *		cob - output variable for current model carbohydrates on board [g]; valid only if the step is done
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, state retrieved
+ *		FALSE (zero) - failure - parameters are invalid
+ */
+extern "C" BOOL IfaceCalling scgms_game_poll_step(scgms_game_wrapper_t wrapper, uint64_t ticket, NGame_Step_State* state, double* bg, double* ig, double* iob, double* cob);
+
+/*
+ * scgms_game_wait_step
+ *
+ * Waits for a step queued by scgms_game_step_async to be performed
+ * Once the step is reported as done or failed, its result is released and the ticket becomes unknown
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		ticket - ticket obtained from scgms_game_step_async call
+ *		timeout_ms - maximum time to wait in milliseconds; Infinite_Wait_Timeout (UINT32_MAX) to wait until the step is performed
+ *		state - output variable for the step state; Pending, if the timeout has expired
+ *		bg - output variable for blood glucose reading [mmol/L]; valid only if the step is done
+ *		ig - output variable for interstitial glucose reading [mmol/L]; valid only if the step is done
+ *		iob - output variable for current model insulin on board [U]; valid only if the step is done
+ *		cob - output variable for current model carbohydrates on board [g]; valid only if the step is done
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, state retrieved
+ *		FALSE (zero) - failure - parameters are invalid
+ */
+extern "C" BOOL IfaceCalling scgms_game_wait_step(scgms_game_wrapper_t wrapper, uint64_t ticket, uint32_t timeout_ms, NGame_Step_State* state, double* bg, double* ig, double* iob, double* cob);
+
+/*
+ * scgms_game_checkpoint
+ *
+ * Marks the current state of the simulation, so it could be restored later; the call itself is cheap, it just stores the position in the session history
+ * Up to Max_Checkpoint_Count recent checkpoints are kept; creating another one discards the oldest
+ * Filters do not expose their internal state, so the state of the simulation chain is not captured; it is reproduced by scgms_game_restore call instead
+ * The history is journaled in memory, consecutive steps without inputs take a single entry
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		checkpoint_id - output variable for the ID of created checkpoint
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_checkpoint(scgms_game_wrapper_t wrapper, uint32_t* checkpoint_id);
+
+/*
+ * scgms_game_restore
+ *
+ * Returns the simulation to the state captured by given checkpoint; all checkpoints created after it are discarded, the restored checkpoint
+ * remains available (may be restored again)
+ * The current simulation chain is replaced with a new one, which synchronously re-simulates the session history up to the checkpoint; the cost
+ * of the call thus grows with the history length
+ * If the session is logging, the new chain rewrites the log file given at creation, which then contains the history up to the checkpoint followed
+ * by the restored simulation; the abandoned history is not kept
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		checkpoint_id - ID of the checkpoint obtained from scgms_game_checkpoint call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - the checkpoint does not exist (anymore), or the history could not be re-simulated; the game is terminated in the latter case
+ */
+extern "C" BOOL IfaceCalling scgms_game_restore(scgms_game_wrapper_t wrapper, uint32_t checkpoint_id);
+
+/*
+ * scgms_game_get_log_file_path
+ *
+ * Retrieves the path of log file, that contains the simulation history; it is always the path given at creation
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		buffer - output buffer for zero-terminated path
+ *		buffer_size - size of the output buffer in bytes
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - parameters are invalid or the buffer is too small
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_log_file_path(scgms_game_wrapper_t wrapper, char* buffer, size_t buffer_size);
+
+/*
+ * scgms_game_replay_step
+ *
+ * Performs a single step during replay; retains a single event during it - this does not correspond to a time-based stepping, but rather level-based
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_replay_create call
+ *		signal_id - pointer to a memory, where the id of obtained signal is stored
+ *		level - pointer to a memory, where the signal level is stored
+ *		time - pointer to a memory, where the timestamp is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - the simulation ended (no more events will come)
+ */
+extern "C" BOOL IfaceCalling scgms_game_replay_step(scgms_game_wrapper_t wrapper, GUID* signal_id, double* level, double* time);
+
+/*
+ * scgms_game_replay_read
+ *
+ * Reads up to max_events replayed events at once; blocks until at least one event is available or the replay ends
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_replay_create call
+ *		max_events - capacity of output arrays
+ *		signal_ids - output array of signal IDs
+ *		levels - output array of signal levels
+ *		times - output array of timestamps
+ *		count_out - pointer to a memory, where the count of read events is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, at least one event has been read
+ *		FALSE (zero) - the simulation ended (no more events will come) or parameters are invalid
+ */
+extern "C" BOOL IfaceCalling scgms_game_replay_read(scgms_game_wrapper_t wrapper, size_t max_events, GUID* signal_ids, double* levels, double* times, size_t* count_out);
+
+/*
+ * scgms_game_replay_seek
+ *
+ * Restarts the replay from the first level event at or after given time; events buffered so far are discarded
+ * Binary logs are seeked using their time index in O(log n); a CSV log is read whole on the first seek and then replayed from memory
+ * Must not be called concurrently with scgms_game_replay_step or scgms_game_replay_read on the same instance
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_replay_create call
+ *		rat_time - time to seek to, as a rat time (the same time base as device times of replayed events)
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, the replay continues from given time (or ends, if there is no later event)
+ *		FALSE (zero) - failure - the instance is not a replay, or the log could not be read
+ */
+extern "C" BOOL IfaceCalling scgms_game_replay_seek(scgms_game_wrapper_t wrapper, double rat_time);
+
+// level events of a log loaded by scgms_game_log_load; the pointer should never be dereferenced in outer code
+using scgms_game_log_t = TLog_Level_Columns*;
+
+/*
+ * scgms_game_log_load
+ *
+ * Reads all level events of given log file to memory; they are kept loaded until scgms_game_log_free is called
+ *
+ * Parameters:
+ *		log_file_path - path to a log file to be read; either CSV, or binary (.sbl)
+ *		count_out - pointer to a memory, where the count of all level events in the log is stored; may be nullptr
+ *
+ * Return values:
+ *		<a valid scgms_game_log_t pointer> - success
+ *		nullptr - failure, the log could not be read
+ */
+extern "C" scgms_game_log_t IfaceCalling scgms_game_log_load(const char* log_file_path, size_t* count_out);
+
+/*
+ * scgms_game_log_get_events
+ *
+ * Copies level events of a loaded log to output arrays
+ *
+ * Parameters:
+ *		log - log obtained from scgms_game_log_load call
+ *		max_events - capacity of output arrays
+ *		signal_ids - output array of signal IDs
+ *		levels - output array of signal levels
+ *		times - output array of timestamps
+ *		count_out - pointer to a memory, where the count of stored events is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, all events have been stored
+ *		FALSE (zero) - failure, invalid parameters, or the output arrays are too small (they are filled up to their capacity)
+ */
+extern "C" BOOL IfaceCalling scgms_game_log_get_events(scgms_game_log_t log, size_t max_events, GUID* signal_ids, double* levels, double* times, size_t* count_out);
+
+/*
+ * scgms_game_log_free
+ *
+ * Releases a log loaded by scgms_game_log_load
+ *
+ * Parameters:
+ *		log - log obtained from scgms_game_log_load call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure, invalid log
+ */
+extern "C" BOOL IfaceCalling scgms_game_log_free(scgms_game_log_t log);
+
+/*
+ * scgms_game_get_additional_state
+ *
+ * Retrieves an additional state info from the game wrapper; the game should be running (wrapper points to a valid object)
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		requested_signal_ids - pointer to an array of requested signal IDs
+ *		output_signal_levels - a pointer to an array, which will be filled by last known levels of requested signals; NaN for signals not seen yet
+ *		signal_count - count of requested signal IDs and the output array
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure - at least one of the requested state signals were not found (the rest of the output array is still filled)
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_additional_state(scgms_game_wrapper_t wrapper, GUID* requested_signal_ids, double* output_signal_levels, size_t signal_count);
+
+/*
+ * scgms_game_get_startup_profile
+ *
+ * Retrieves durations of the session start-up phases, i.e.; where the time of scgms_game_create (or replay creation) went
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *		phase_durations_ms - output array of phase durations in milliseconds, in the order of NStartup_Phase: config build, config parse, chain creation,
+ *							 segment start, initial step, total; phases not performed by the session (e.g.; config build and parse of a cached configuration) are zero
+ *		phase_count - count of elements of the output array; at most 6 phases are stored, further elements are left untouched
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_startup_profile(scgms_game_wrapper_t wrapper, double* phase_durations_ms, uint32_t phase_count);
+
+/*
+ * scgms_game_set_profiling
+ *
+ * Enables or disables per-filter profiling of sessions and optimizations created afterwards; already running ones are not affected
+ * Profiled chains have a probe in front of each filter, which adds a small overhead to every event
+ *
+ * Parameters:
+ *		enabled - TRUE to enable the profiling, FALSE to disable it
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure, the profiling probe could not be registered to the framework
+ */
+extern "C" BOOL IfaceCalling scgms_game_set_profiling(BOOL enabled);
+
+/*
+ * scgms_game_get_filter_profile
+ *
+ * Retrieves cumulative time and event count of each filter of a profiled session; time spent re-simulating the history on scgms_game_restore calls is included
+ * Each output array is optional (may be nullptr)
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call, while the profiling was enabled
+ *		filter_indices - output array of filter indices within the configuration (without probes)
+ *		filter_ids - output array of filter GUIDs
+ *		event_counts - output array of counts of events, that entered the filter
+ *		total_ns - output array of time spent in the filter itself (without the following filters) in nanoseconds
+ *		capacity - capacity of output arrays
+ *		count_out - pointer to a memory, where the count of profiled filters is stored
+ *
+ * Return values:
+ *		TRUE (non-zero) - success, all filters have been stored
+ *		FALSE (zero) - failure, the session is not profiled, or the output arrays are too small (count_out then holds the required capacity)
+ */
+extern "C" BOOL IfaceCalling scgms_game_get_filter_profile(scgms_game_wrapper_t wrapper, uint32_t* filter_indices, GUID* filter_ids, uint64_t* event_counts, uint64_t* total_ns,
+	uint32_t capacity, uint32_t* count_out);
+
+/*
+ * scgms_game_terminate
+ *
+ * Terminates the running game, invalidates the obtained scgms_game_wrapper_t object. May block due to yet unprocessed events.
+ *
+ * Parameters:
+ *		wrapper - pointer to a game wrapper instance obtained from scgms_game_create call
+ *
+ * Return values:
+ *		TRUE (non-zero) - success
+ *		FALSE (zero) - failure
+ */
+extern "C" BOOL IfaceCalling scgms_game_terminate(scgms_game_wrapper_t wrapper);
@@ -0,0 +1,138 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "log-loader.h"
+#include "configs.h"
+#include "binary-log.h"
+
+#include <scgms/rtl/referencedImpl.h>
+
+#include <filesystem>
+
+// rough size of a single line of CSV log; used just to estimate the count of events to reserve space for
+constexpr const size_t Estimated_Log_Line_Length = 96;
+
+CLog_Record_Collector::CLog_Record_Collector(const std::function<void(const TBinary_Log_Record&)>& consumer) : mConsumer(consumer)
+{
+	//
+}
+
+HRESULT IfaceCalling CLog_Record_Collector::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT IfaceCalling CLog_Record_Collector::Execute(scgms::IDevice_Event *event)
+{
+	scgms::UDevice_Event evt{ event };
+
+	TBinary_Log_Record rec;
+	if (To_Binary_Log_Record(evt, rec))
+		mConsumer(rec);
+
+	return S_OK;
+}
+
+bool Load_Log(const std::string& log_file_path, const std::function<void(size_t)>& reserve, const std::function<void(const TBinary_Log_Record&)>& consumer)
+{
+	if (Is_Binary_Log_Path(log_file_path))
+	{
+		CBinary_Log_Reader reader;
+		if (!reader.Open(log_file_path))
+			return false;
+
+		reserve(reader.Size());
+
+		for (const auto& rec : reader)
+			consumer(rec);
+
+		return true;
+	}
+
+	std::error_code ec;
+	const auto file_size = std::filesystem::file_size(log_file_path, ec);
+	if (ec)
+		return false;
+
+	reserve(static_cast<size_t>(file_size / Estimated_Log_Line_Length));
+
+	const std::string config = Get_Replay_Config(log_file_path);
+
+	refcnt::Swstr_list errors;
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	if (!configuration || configuration->Load_From_Memory(config.c_str(), config.size(), errors.get()) != S_OK)
+		return false;
+
+	CLog_Record_Collector collector{ consumer };
+
+	scgms::SFilter_Executor ex{ configuration, nullptr, nullptr, errors, &collector };
+	if (!ex)
+		return false;
+
+	// the replay emits shut down after the last event; wait for it, so the consumer has got all events
+	ex->Terminate(TRUE);
+
+	return true;
+}
+
+bool Load_Log_Level_Events(const std::string& log_file_path, TLog_Level_Columns& target)
+{
+	auto reserve = [&target](size_t count) {
+		const size_t expected = target.Size() + count;
+		target.signal_ids.reserve(expected);
+		target.levels.reserve(expected);
+		target.device_times.reserve(expected);
+	};
+
+	auto consumer = [&target](const TBinary_Log_Record& rec) {
+		if (rec.event_code != static_cast<uint32_t>(scgms::NDevice_Event_Code::Level))
+			return;
+
+		target.signal_ids.push_back(rec.signal_id);
+		target.levels.push_back(rec.level);
+		target.device_times.push_back(rec.device_time);
+	};
+
+	return Load_Log(log_file_path, reserve, consumer);
+}
+
+bool Load_Log_Events(const std::string& log_file_path, std::vector<TBinary_Log_Record>& target)
+{
+	return Load_Log(log_file_path,
+		[&target](size_t count) { target.reserve(target.size() + count); },
+		[&target](const TBinary_Log_Record& rec) { target.push_back(rec); }
+	);
+}
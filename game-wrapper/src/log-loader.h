@@ -0,0 +1,99 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/iface/referencedIface.h>
+
+#include "binary-log.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// level events of a game log stored column-wise
+struct TLog_Level_Columns
+{
+	std::vector<GUID> signal_ids;
+	std::vector<double> levels;
+	std::vector<double> device_times;
+
+	size_t Size() const
+	{
+		return levels.size();
+	}
+
+	void Clear()
+	{
+		signal_ids.clear();
+		levels.clear();
+		device_times.clear();
+	}
+};
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Terminal filter of a log replay chain, which passes all events representable by binary log records to a consumer
+ */
+class CLog_Record_Collector : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
+{
+	private:
+		const std::function<void(const TBinary_Log_Record&)>& mConsumer;
+
+	public:
+		CLog_Record_Collector(const std::function<void(const TBinary_Log_Record&)>& consumer);
+		virtual ~CLog_Record_Collector() = default;
+
+		// scgms::IFilter iface
+		virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description);
+		virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event);
+};
+
+#pragma warning( pop )
+
+// replays the whole log file (CSV or binary) and passes its events to the consumer in the log order, as if they were read from a binary log;
+// reserve is called first with the estimated count of events; blocks until the log is read
+bool Load_Log(const std::string& log_file_path, const std::function<void(size_t)>& reserve, const std::function<void(const TBinary_Log_Record&)>& consumer);
+
+// replays the whole log file and appends its level events to the target columns; blocks until the log is read
+bool Load_Log_Level_Events(const std::string& log_file_path, TLog_Level_Columns& target);
+
+// replays the whole log file (CSV or binary) and appends its events to the target, as if they were read from a binary log; blocks until the log is read
+bool Load_Log_Events(const std::string& log_file_path, std::vector<TBinary_Log_Record>& target);
@@ -0,0 +1,310 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "optimizer-cache.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+uint64_t Hash_Log_Events(const std::vector<TBinary_Log_Record>& events)
+{
+	// FNV-1a; records have no padding, so hashing their bytes is deterministic
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(events.data());
+	const size_t size = events.size() * sizeof(TBinary_Log_Record);
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+uint64_t Combine_Log_Hashes(std::vector<uint64_t> hashes)
+{
+	if (hashes.size() == 1)
+		return hashes.front();
+
+	// FNV-1a over the sorted hashes; the order of logs does not affect the fitness, so it should not affect the hash either
+	std::sort(hashes.begin(), hashes.end());
+
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	for (const uint64_t log_hash : hashes)
+	{
+		for (size_t i = 0; i < sizeof(log_hash); i++)
+		{
+			hash ^= (log_hash >> (i * 8)) & 0xFF;
+			hash *= 0x100000001B3ULL;
+		}
+	}
+
+	return hash;
+}
+
+uint64_t Hash_Config(const std::string& config)
+{
+	// FNV-1a
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	for (const char c : config)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+COptimization_Cache& COptimization_Cache::Instance()
+{
+	static COptimization_Cache cache;
+	return cache;
+}
+
+bool COptimization_Cache::Set_Directory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	if (directory.empty())
+	{
+		mDirectory.clear();
+		return true;
+	}
+
+	const std::filesystem::path path{ directory };
+
+	std::error_code ec;
+	std::filesystem::create_directories(path, ec);
+	if (!std::filesystem::is_directory(path, ec))
+		return false;
+
+	mDirectory = path;
+	return true;
+}
+
+bool COptimization_Cache::Is_Enabled()
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+	return !mDirectory.empty();
+}
+
+std::filesystem::path COptimization_Cache::Get_File_Path(const TOptimization_Cache_Key& key) const
+{
+	const std::string name = Narrow_WString(GUID_To_WString(key.config_id)) + "_" + Narrow_WString(GUID_To_WString(key.parameters_id)) + "_" + std::to_string(key.stepping_ms);
+
+	return mDirectory / (name + Optimization_Cache_Extension);
+}
+
+std::vector<TOptimization_Cache_Result> COptimization_Cache::Read(const TOptimization_Cache_Key& key) const
+{
+	std::vector<TOptimization_Cache_Result> results;
+
+	std::ifstream file(Get_File_Path(key), std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return results;
+
+	// counts stored in the file are checked against its size, so a corrupted file cannot make us allocate arbitrary amounts of memory
+	const std::streamoff file_size = file.tellg();
+	if (file_size < static_cast<std::streamoff>(sizeof(TOptimization_Cache_Header)) || !file.seekg(0))
+		return results;
+
+	uint64_t remaining = static_cast<uint64_t>(file_size) - sizeof(TOptimization_Cache_Header);
+
+	TOptimization_Cache_Header header{};
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return results;
+
+	if (std::memcmp(header.magic, Optimization_Cache_Magic, sizeof(header.magic)) != 0 || header.version != Optimization_Cache_Version
+		|| header.config_id != key.config_id || header.parameters_id != key.parameters_id || header.stepping_ms != key.stepping_ms)
+		return results;
+
+	if (header.result_count > remaining / sizeof(TOptimization_Cache_Result_Header))
+		return results;
+
+	results.reserve(header.result_count);
+
+	for (uint32_t i = 0; i < header.result_count; i++)
+	{
+		TOptimization_Cache_Result_Header result_header{};
+		if (!file.read(reinterpret_cast<char*>(&result_header), sizeof(result_header)))
+			return {};
+
+		remaining -= sizeof(result_header);
+		if (result_header.value_count > remaining / sizeof(double))
+			return {};
+
+		remaining -= result_header.value_count * sizeof(double);
+
+		TOptimization_Cache_Result result;
+		result.log_hash = result_header.log_hash;
+		result.config_hash = result_header.config_hash;
+		result.metric = result_header.metric;
+		result.degree_of_opt = result_header.degree_of_opt;
+		result.values.resize(result_header.value_count);
+
+		if (!file.read(reinterpret_cast<char*>(result.values.data()), static_cast<std::streamsize>(result.values.size() * sizeof(double))))
+			return {};
+
+		results.push_back(std::move(result));
+	}
+
+	return results;
+}
+
+bool COptimization_Cache::Write(const TOptimization_Cache_Key& key, const std::vector<TOptimization_Cache_Result>& results) const
+{
+	const std::filesystem::path path = Get_File_Path(key);
+
+	// write to a temporary file first, so other processes never read a partially written file; the name is random, as other processes may be
+	// writing the same cache file at once
+	std::ostringstream suffix;
+	suffix << ".tmp" << std::hex << std::random_device{}() << std::random_device{}();
+
+	std::filesystem::path temp_path = path;
+	temp_path += suffix.str();
+
+	{
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		TOptimization_Cache_Header header{};
+		std::memcpy(header.magic, Optimization_Cache_Magic, sizeof(header.magic));
+		header.version = Optimization_Cache_Version;
+		header.stepping_ms = key.stepping_ms;
+		header.config_id = key.config_id;
+		header.parameters_id = key.parameters_id;
+		header.result_count = static_cast<uint32_t>(results.size());
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& result : results)
+		{
+			TOptimization_Cache_Result_Header result_header{};
+			result_header.log_hash = result.log_hash;
+			result_header.config_hash = result.config_hash;
+			result_header.metric = result.metric;
+			result_header.degree_of_opt = result.degree_of_opt;
+			result_header.value_count = static_cast<uint32_t>(result.values.size());
+
+			file.write(reinterpret_cast<const char*>(&result_header), sizeof(result_header));
+			file.write(reinterpret_cast<const char*>(result.values.data()), static_cast<std::streamsize>(result.values.size() * sizeof(double)));
+		}
+
+		if (!file.good())
+			return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temp_path, path, ec);
+	if (ec)
+	{
+		std::filesystem::remove(temp_path, ec);
+		return false;
+	}
+
+	return true;
+}
+
+bool COptimization_Cache::Find_Exact(const TOptimization_Cache_Key& key, uint64_t log_hash, uint64_t config_hash, uint16_t degree_of_opt, std::vector<double>& values)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	if (mDirectory.empty())
+		return false;
+
+	for (auto& result : Read(key))
+	{
+		if (result.log_hash == log_hash && result.config_hash == config_hash && result.degree_of_opt >= degree_of_opt)
+		{
+			values = std::move(result.values);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::vector<TOptimization_Cache_Result> COptimization_Cache::Find_Similar(const TOptimization_Cache_Key& key, uint64_t log_hash, size_t max_count)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	if (mDirectory.empty())
+		return {};
+
+	std::vector<TOptimization_Cache_Result> results = Read(key);
+
+	// the same log optimized less thoroughly is the best hint of all
+	std::stable_sort(results.begin(), results.end(), [log_hash](const TOptimization_Cache_Result& a, const TOptimization_Cache_Result& b) {
+		if ((a.log_hash == log_hash) != (b.log_hash == log_hash))
+			return a.log_hash == log_hash;
+		return a.metric < b.metric;
+	});
+
+	if (results.size() > max_count)
+		results.resize(max_count);
+
+	return results;
+}
+
+bool COptimization_Cache::Store(const TOptimization_Cache_Key& key, const TOptimization_Cache_Result& result)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	if (mDirectory.empty())
+		return false;
+
+	std::vector<TOptimization_Cache_Result> results = Read(key);
+
+	results.erase(std::remove_if(results.begin(), results.end(), [&result](const TOptimization_Cache_Result& r) { return r.log_hash == result.log_hash; }), results.end());
+
+	// the most recent result goes first
+	results.insert(results.begin(), result);
+	if (results.size() > Max_Optimization_Cache_Results)
+		results.resize(Max_Optimization_Cache_Results);
+
+	return Write(key, results);
+}
@@ -0,0 +1,146 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/rtl/guid.h>
+
+#include "binary-log.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Persistent cache of optimization results
+ * Results are grouped by config, patient and stepping; each group is stored in its own file and holds the most recent results, one per input log
+ * The input log is identified by a hash of its events, so the same gameplay stored as CSV and as binary log is considered equal
+ * Each result is tagged with a hash of the expanded config; an exact hit requires the same hash, so a changed template or patient database is optimized again
+ */
+
+// cache files use this extension
+constexpr const char* Optimization_Cache_Extension = ".soc";
+
+constexpr const char Optimization_Cache_Magic[8] = { 'S', 'C', 'G', 'M', 'S', 'O', 'C', '\0' };
+constexpr const uint32_t Optimization_Cache_Version = 2;
+
+// maximum count of results kept per group; the oldest results are dropped first
+constexpr const size_t Max_Optimization_Cache_Results = 16;
+
+struct TOptimization_Cache_Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t stepping_ms;
+	GUID config_id;
+	GUID parameters_id;
+	uint32_t result_count;
+	uint32_t reserved;
+};
+
+// a single result; followed by value_count doubles
+struct TOptimization_Cache_Result_Header
+{
+	uint64_t log_hash;
+	uint64_t config_hash;
+	double metric;
+	uint16_t degree_of_opt;
+	uint16_t reserved;
+	uint32_t value_count;
+};
+
+static_assert(sizeof(TOptimization_Cache_Header) == 56, "Optimization cache header must be 56 bytes long");
+static_assert(sizeof(TOptimization_Cache_Result_Header) == 32, "Optimization cache result header must be 32 bytes long");
+
+// identifies a group of results, that may serve as hints to each other
+struct TOptimization_Cache_Key
+{
+	GUID config_id;
+	GUID parameters_id;
+	uint32_t stepping_ms;
+};
+
+struct TOptimization_Cache_Result
+{
+	uint64_t log_hash = 0;
+	// hash of the expanded config, the result was optimized with
+	uint64_t config_hash = 0;
+	double metric = 0;
+	uint16_t degree_of_opt = 0;
+	// the whole optimized parameter (lower bounds, values and upper bounds)
+	std::vector<double> values;
+};
+
+// calculates hash of events of a log; used to recognize the same input log
+uint64_t Hash_Log_Events(const std::vector<TBinary_Log_Record>& events);
+// combines hashes of logs optimized together; a single log keeps its own hash
+uint64_t Combine_Log_Hashes(std::vector<uint64_t> hashes);
+// calculates hash of an expanded config; used to recognize results optimized with a different template or patient
+uint64_t Hash_Config(const std::string& config);
+
+/*
+ * Process-wide optimization result cache; disabled until a directory is set
+ */
+class COptimization_Cache
+{
+	private:
+		std::mutex mMtx;
+		std::filesystem::path mDirectory;
+
+		COptimization_Cache() = default;
+
+		std::filesystem::path Get_File_Path(const TOptimization_Cache_Key& key) const;
+		// reads all results of the group; missing or malformed files yield no results
+		std::vector<TOptimization_Cache_Result> Read(const TOptimization_Cache_Key& key) const;
+		bool Write(const TOptimization_Cache_Key& key, const std::vector<TOptimization_Cache_Result>& results) const;
+
+	public:
+		static COptimization_Cache& Instance();
+
+		// sets directory of cache files and creates it, if needed; an empty path disables the cache
+		bool Set_Directory(const std::string& directory);
+		bool Is_Enabled();
+
+		// retrieves result of an optimization of the same log with the same expanded config, that was at least as thorough as requested
+		bool Find_Exact(const TOptimization_Cache_Key& key, uint64_t log_hash, uint64_t config_hash, uint16_t degree_of_opt, std::vector<double>& values);
+		// retrieves results of the group, that may serve as solver hints; less thorough results of the same log go first, then other logs from the best metric
+		std::vector<TOptimization_Cache_Result> Find_Similar(const TOptimization_Cache_Key& key, uint64_t log_hash, size_t max_count);
+		// stores the result, replaces previous result of the same log
+		bool Store(const TOptimization_Cache_Key& key, const TOptimization_Cache_Result& result);
+};
@@ -0,0 +1,215 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "optimizer-scheduler.h"
+#include "game-optimizer-wrapper.h"
+
+#include <algorithm>
+#include <thread>
+
+// default count of concurrently running optimalizations; while one job waits for the slowest evaluations of a generation, the other one keeps the cores busy
+constexpr const size_t Default_Optimization_Slot_Count = 2;
+
+static size_t Get_Hardware_Thread_Count()
+{
+	return static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+COptimization_Scheduler::COptimization_Scheduler() : mSlot_Count(std::min(Default_Optimization_Slot_Count, Get_Hardware_Thread_Count()))
+{
+	//
+}
+
+COptimization_Scheduler::~COptimization_Scheduler()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	// the process is exiting with optimalizations still queued or running (Shut_Down was not called); cancelled jobs end at their closest cancel point,
+	// queued ones right after the runners take them from the queue
+	for (auto& queued : mQueue)
+		queued.job->Cancel_Scheduled();
+
+	for (auto& runner : mRunners)
+	{
+		if (runner.job)
+			runner.job->Cancel_Scheduled();
+	}
+
+	mRunner_Finished_Cv.wait(lck, [this]() { return mRunner_Count == 0; });
+
+	Join_Finished_Runners();
+}
+
+COptimization_Scheduler& COptimization_Scheduler::Instance()
+{
+	static COptimization_Scheduler scheduler;
+	return scheduler;
+}
+
+void COptimization_Scheduler::Set_Slot_Count(size_t slot_count)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	mSlot_Count = (slot_count != 0) ? slot_count : std::min(Default_Optimization_Slot_Count, Get_Hardware_Thread_Count());
+
+	// surplus runners exit on their own, once they finish their current job
+	Start_Runners();
+}
+
+size_t COptimization_Scheduler::Get_Default_Job_Thread_Count()
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	return std::max<size_t>(1, Get_Hardware_Thread_Count() / mSlot_Count);
+}
+
+void COptimization_Scheduler::Shut_Down()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	mRunner_Finished_Cv.wait(lck, [this]() { return mRunner_Count == 0; });
+
+	Join_Finished_Runners();
+}
+
+void COptimization_Scheduler::Join_Finished_Runners()
+{
+	// a finished runner has released the lock for good, so it cannot block the join
+	for (auto itr = mRunners.begin(); itr != mRunners.end(); )
+	{
+		if (itr->finished)
+		{
+			itr->thread.join();
+			itr = mRunners.erase(itr);
+		}
+		else
+			itr++;
+	}
+}
+
+void COptimization_Scheduler::Start_Runners()
+{
+	Join_Finished_Runners();
+
+	while (mRunner_Count < mSlot_Count && mRunner_Count < mQueue.size())
+	{
+		mRunner_Count++;
+
+		mRunners.emplace_back();
+		TRunner* runner = &mRunners.back();
+		runner->thread = std::thread(&COptimization_Scheduler::Runner_Fnc, this, runner);
+	}
+}
+
+void COptimization_Scheduler::Runner_Fnc(TRunner* runner)
+{
+	while (true)
+	{
+		CGame_Optimizer_Wrapper* job = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lck(mMtx);
+
+			if (mQueue.empty() || mRunner_Count > mSlot_Count)
+			{
+				mRunner_Count--;
+				runner->finished = true;
+				mRunner_Finished_Cv.notify_all();
+				return;
+			}
+
+			// highest priority first, then the oldest job
+			auto next = std::min_element(mQueue.begin(), mQueue.end(), [](const TQueued_Job& a, const TQueued_Job& b) {
+				if (a.priority != b.priority)
+					return a.priority > b.priority;
+				return a.sequence < b.sequence;
+			});
+
+			job = next->job;
+			mQueue.erase(next);
+
+			runner->job = job;
+		}
+
+		// the job may get destroyed as soon as it reports its final state, so it must not be touched afterwards; it calls Release_Running before that
+		job->Run_Scheduled();
+	}
+}
+
+void COptimization_Scheduler::Submit(CGame_Optimizer_Wrapper* job, int32_t priority)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	mQueue.push_back(TQueued_Job{ job, priority, mNext_Sequence++ });
+
+	Start_Runners();
+}
+
+bool COptimization_Scheduler::Remove(CGame_Optimizer_Wrapper* job)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	auto itr = std::find_if(mQueue.begin(), mQueue.end(), [job](const TQueued_Job& queued) { return queued.job == job; });
+	if (itr == mQueue.end())
+		return false;
+
+	mQueue.erase(itr);
+	return true;
+}
+
+void COptimization_Scheduler::Release_Running(CGame_Optimizer_Wrapper* job)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	for (auto& runner : mRunners)
+	{
+		if (runner.job == job)
+			runner.job = nullptr;
+	}
+}
+
+bool COptimization_Scheduler::Set_Priority(CGame_Optimizer_Wrapper* job, int32_t priority)
+{
+	std::lock_guard<std::mutex> lck(mMtx);
+
+	auto itr = std::find_if(mQueue.begin(), mQueue.end(), [job](const TQueued_Job& queued) { return queued.job == job; });
+	if (itr == mQueue.end())
+		return false;
+
+	itr->priority = priority;
+	return true;
+}
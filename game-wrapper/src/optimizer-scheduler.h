@@ -0,0 +1,116 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CGame_Optimizer_Wrapper;
+
+/*
+ * Process-wide scheduler of optimalizations
+ * At most a given count of optimalizations (slots) runs at once, the rest waits in a queue; jobs of higher priority go first, jobs of the same priority in FIFO order
+ * Slots are served by runner threads, that are started on demand and exit once the queue is empty; the scheduler owns and joins them
+ * Runners execute library code until they exit, so the library must not be unloaded before Shut_Down returns
+ * If the scheduler gets destroyed with jobs still queued or running, it cancels them all and joins the runners
+ */
+class COptimization_Scheduler
+{
+	private:
+		struct TQueued_Job
+		{
+			CGame_Optimizer_Wrapper* job;
+			int32_t priority;
+			uint64_t sequence;
+		};
+
+		struct TRunner
+		{
+			std::thread thread;
+			// has the runner left its loop? it is then joined without waiting
+			bool finished = false;
+			// job being run; cleared before the job reports its final state, as the job may get destroyed right after that
+			CGame_Optimizer_Wrapper* job = nullptr;
+		};
+
+		std::mutex mMtx;
+		std::vector<TQueued_Job> mQueue;
+		uint64_t mNext_Sequence = 0;
+
+		size_t mSlot_Count;
+		// count of running runner threads; never exceeds mSlot_Count, except for a moment after the slot count gets lowered
+		size_t mRunner_Count = 0;
+		// all runner threads, that have not been joined yet; a list, so the runners may refer to their own entries
+		std::list<TRunner> mRunners;
+		// signalled, whenever a runner finishes
+		std::condition_variable mRunner_Finished_Cv;
+
+		COptimization_Scheduler();
+		~COptimization_Scheduler();
+
+		// joins runners, that have already finished; mMtx must be locked
+		void Join_Finished_Runners();
+		// starts runner threads for queued jobs up to the slot count; mMtx must be locked
+		void Start_Runners();
+		// runs queued jobs until the queue is empty
+		void Runner_Fnc(TRunner* runner);
+
+	public:
+		static COptimization_Scheduler& Instance();
+
+		// waits until the queue is empty and all runners have finished, and joins them
+		void Shut_Down();
+
+		// sets count of concurrently running optimalizations; zero restores the default
+		void Set_Slot_Count(size_t slot_count);
+		// count of evaluation threads of a job, that does not specify it; the hardware threads are shared by all slots
+		size_t Get_Default_Job_Thread_Count();
+
+		// enqueues the job; the job gets run on a runner thread
+		void Submit(CGame_Optimizer_Wrapper* job, int32_t priority = 0);
+		// removes the job from the queue; returns false if the job is not queued (i.e.; it is already running or has finished)
+		bool Remove(CGame_Optimizer_Wrapper* job);
+		// changes priority of a queued job; returns false if the job is not queued
+		bool Set_Priority(CGame_Optimizer_Wrapper* job, int32_t priority);
+		// called by a running job just before it reports its final state; the scheduler does not touch the job afterwards
+		void Release_Running(CGame_Optimizer_Wrapper* job);
+};
@@ -0,0 +1,406 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "patient-db.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#undef min
+#undef max
+
+namespace patients
+{
+	const GUID patient_s2013_1 = { 0x7e685b57, 0x8ef2, 0x4ce5, { 0x93, 0x8b, 0x7b, 0xdf, 0x2a, 0x88, 0x6c, 0x89 } }; // {7E685B57-8EF2-4CE5-938B-7BDF2A886C89}
+	const char* rsParams_s2013_1 = "0 0 0 20 20 0 0 0 0 0 0 0 20 10 30 10.2 0 1 0 0.2 0.05 0.4 0.005 0.005 100 0.01 0.005 0.001 0.01 0.05 0.001 0.05 0.0001 0.0001 0.002 0.05 1e-05 20 0.1 0.2 0.002 0.008 0.0001 0.0005 0.05 1 0.01 0.01 0.01 1 0 0 0 0 0 0 0 0 0 1 1 0 0 0 265.37 162.457 5.50433 0 100.25 100.25 3.20763 72.4342 141.154 265.37 102.32 138.56 100.25 0.08906 0.046122 0.003793 0.70391 0.21057 1.9152 0.054906 0.031319 253.52 0.087114 0.058138 0.027802 0.15446 0.225027 0.09001099999999999 0.23169 0.004637 0.00469 0.01208 0.9 0.0005 339 1 3.26673 0.0152 0.0766 0.0019 0.0078 1.23862 4.73141 0.05 0.05 0.05 10 0.95 0.12 0.4 0.3 0.08 0.02 0.05 30 0 15 15 500 500 500 500 500 50 300 200 300 200 500 500 500 250 300 200 0.8 1 0.5 2 2 10 2 0.5 500 0.6 0.2 0.2 0.9 1 1 1 0.05 0.02 0.5 3 0.01 1000 5 20 0.8 0.9 0.05 0.1 10 20 1 1 1 100 3 1 2 2 1 0.8 1 200 200 100 100";
+
+	const GUID patient_gct_1 = { 0x87d58e17, 0x3968, 0x45eb, { 0x90, 0xb9, 0x47, 0x17, 0xc3, 0xc8, 0x6, 0x9f } }; // {87D58E17-3968-45EB-90B9-4717C3C8069F}
+	const char* rsParams_GCT_1 = "0 0 0 0 0 0 0 0 30 25 30 50 8 4 0.01 1.4 1.4 0.001 14 14 0.144 0.144 0.001 0.01 1e-05 0.0001 0 2000 500 2000 500 300 100 0.5 0.006944444444444445 0.003472222222222222 135 65 450 4e-12 16.2 2.6 0 54.8 30 25 80 240 8 5 0.01 8 3.4 0.07697 144 144 0.38519 0.38519 0.8 0.01 0.01 0.1 0 9000 2000 7425 2000 1800 300 0.98 0.03055555555555556 0.08263888888888889 500 500 500 500 500 500 200 200 60 60 80 1000 14 8 0.9 24 144 3 144 144 14.4 14.4 0.8 2 0.01 0.1 0.05 12000 12000 9000 9000 2500 1800 0.98 0.03472222222222222 0.08333333333333334";
+
+	struct TBuiltin_Patient_Definition
+	{
+		const GUID& id;
+		uint32_t config_class;
+		uint32_t config_id;
+		const char* params;
+	};
+
+	const TBuiltin_Patient_Definition builtins[] = {
+		{ patient_s2013_1, 1, 1, rsParams_s2013_1 },	// Ikaros - S2013, easy
+
+		{ patient_gct_1, 4, 1, rsParams_GCT_1 },		// Ikaros - GCT, easy
+	};
+}
+
+static uint64_t Make_Selector(uint32_t config_class, uint32_t config_id)
+{
+	return (static_cast<uint64_t>(config_class) << 32) | config_id;
+}
+
+CPatient_Database::~CPatient_Database()
+{
+	Close();
+}
+
+bool CPatient_Database::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	const std::wstring wpath = std::filesystem::path{ path }.wstring();
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(TPatient_Database_Header)))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mFile_Handle = file;
+	mMapping_Handle = mapping;
+	mMapping = view;
+	mMapping_Size = static_cast<size_t>(file_size.QuadPart);
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TPatient_Database_Header)))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return false;
+
+	// a session touches just a single patient
+	madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+
+	mMapping = view;
+	mMapping_Size = static_cast<size_t>(st.st_size);
+#endif
+
+	const TPatient_Database_Header* header = static_cast<const TPatient_Database_Header*>(mMapping);
+	if (std::memcmp(header->magic, Patient_Database_Magic, sizeof(header->magic)) != 0 || header->version != Patient_Database_Version || header->entry_size != sizeof(TPatient_Database_Entry)
+		|| header->entry_count > (mMapping_Size - sizeof(TPatient_Database_Header)) / sizeof(TPatient_Database_Entry))
+	{
+		Close();
+		return false;
+	}
+
+	const uint8_t* base = static_cast<const uint8_t*>(mMapping);
+	mEntries = reinterpret_cast<const TPatient_Database_Entry*>(base + sizeof(TPatient_Database_Header));
+	mEntry_Count = static_cast<size_t>(header->entry_count);
+
+	// validate all entries up front, so the lookups may hand out pointers to the mapping without further checks
+	for (size_t i = 0; i < mEntry_Count; i++)
+	{
+		const auto& entry = mEntries[i];
+
+		const bool sorted = (i == 0) || (mEntries[i - 1].id < entry.id);
+		const bool aligned = (entry.values_offset % alignof(double)) == 0;
+		const bool in_bounds = entry.values_offset <= mMapping_Size && entry.value_count <= (mMapping_Size - entry.values_offset) / sizeof(double);
+
+		if (!sorted || !aligned || !in_bounds)
+		{
+			Close();
+			return false;
+		}
+
+		mSelectors[Make_Selector(entry.config_class, entry.config_id)] = i;
+	}
+
+	return true;
+}
+
+void CPatient_Database::Close()
+{
+	if (mMapping)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mMapping);
+		CloseHandle(mMapping_Handle);
+		CloseHandle(mFile_Handle);
+
+		mMapping_Handle = nullptr;
+		mFile_Handle = nullptr;
+#else
+		munmap(mMapping, mMapping_Size);
+#endif
+	}
+
+	mMapping = nullptr;
+	mMapping_Size = 0;
+	mEntries = nullptr;
+	mEntry_Count = 0;
+	mSelectors.clear();
+}
+
+TPatient_Parameters CPatient_Database::To_Parameters(const TPatient_Database_Entry& entry) const
+{
+	TPatient_Parameters parameters;
+	parameters.id = &entry.id;
+	parameters.config_class = entry.config_class;
+	parameters.config_id = entry.config_id;
+	parameters.values = reinterpret_cast<const double*>(static_cast<const uint8_t*>(mMapping) + entry.values_offset);
+	parameters.value_count = entry.value_count;
+
+	return parameters;
+}
+
+bool CPatient_Database::Find(const GUID& id, TPatient_Parameters& parameters) const
+{
+	const TPatient_Database_Entry* end = mEntries + mEntry_Count;
+	const TPatient_Database_Entry* itr = std::lower_bound(mEntries, end, id, [](const TPatient_Database_Entry& entry, const GUID& id) { return entry.id < id; });
+
+	if (itr == end || !(itr->id == id))
+		return false;
+
+	parameters = To_Parameters(*itr);
+	return true;
+}
+
+bool CPatient_Database::Find(uint32_t config_class, uint32_t config_id, TPatient_Parameters& parameters) const
+{
+	auto itr = mSelectors.find(Make_Selector(config_class, config_id));
+	if (itr == mSelectors.end())
+		return false;
+
+	parameters = To_Parameters(mEntries[itr->second]);
+	return true;
+}
+
+bool Write_Patient_Database(const std::string& path, std::vector<TPatient_Record> patients)
+{
+	std::sort(patients.begin(), patients.end(), [](const TPatient_Record& a, const TPatient_Record& b) { return a.id < b.id; });
+
+	for (size_t i = 1; i < patients.size(); i++)
+	{
+		if (patients[i - 1].id == patients[i].id)
+			return false;
+	}
+
+	std::ofstream file(std::filesystem::path{ path }, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	TPatient_Database_Header header{};
+	std::memcpy(header.magic, Patient_Database_Magic, sizeof(header.magic));
+	header.version = Patient_Database_Version;
+	header.entry_size = sizeof(TPatient_Database_Entry);
+	header.entry_count = patients.size();
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// parameters follow the entry table; the table size is a multiple of 8 bytes, so the doubles stay aligned
+	uint64_t values_offset = sizeof(TPatient_Database_Header) + patients.size() * sizeof(TPatient_Database_Entry);
+
+	for (const auto& patient : patients)
+	{
+		TPatient_Database_Entry entry{};
+		entry.id = patient.id;
+		entry.config_class = patient.config_class;
+		entry.config_id = patient.config_id;
+		entry.values_offset = values_offset;
+		entry.value_count = static_cast<uint32_t>(patient.values.size());
+		// always zero-terminated, longer names are truncated
+		std::strncpy(entry.name, patient.name.c_str(), Patient_Name_Size - 1);
+
+		file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+		values_offset += patient.values.size() * sizeof(double);
+	}
+
+	for (const auto& patient : patients)
+		file.write(reinterpret_cast<const char*>(patient.values.data()), patient.values.size() * sizeof(double));
+
+	file.close();
+
+	return !file.fail();
+}
+
+CPatient_Registry::CPatient_Registry()
+{
+	for (const auto& def : patients::builtins)
+	{
+		TBuiltin_Patient builtin{ def.config_class, def.config_id, def.params, {} };
+
+		std::istringstream iss(builtin.text);
+		iss.imbue(std::locale::classic());
+
+		double value;
+		while (iss >> value)
+			builtin.values.push_back(value);
+
+		mBuiltins.emplace(def.id, std::move(builtin));
+	}
+}
+
+CPatient_Registry& CPatient_Registry::Instance()
+{
+	static CPatient_Registry registry;
+	return registry;
+}
+
+TPatient_Parameters CPatient_Registry::To_Parameters(const std::map<GUID, TBuiltin_Patient>::value_type& builtin) const
+{
+	TPatient_Parameters parameters;
+	parameters.id = &builtin.first;
+	parameters.config_class = builtin.second.config_class;
+	parameters.config_id = builtin.second.config_id;
+	parameters.values = builtin.second.values.data();
+	parameters.value_count = builtin.second.values.size();
+
+	return parameters;
+}
+
+bool CPatient_Registry::Load_Database(const std::string& path)
+{
+	auto database = std::make_unique<CPatient_Database>();
+	if (!database->Open(path))
+		return false;
+
+	std::lock_guard<std::mutex> lck(mMtx);
+	mDatabases.push_back(std::move(database));
+
+	return true;
+}
+
+bool CPatient_Registry::Find(const GUID& id, TPatient_Parameters& parameters) const
+{
+	{
+		std::lock_guard<std::mutex> lck(mMtx);
+		for (auto itr = mDatabases.rbegin(); itr != mDatabases.rend(); ++itr)
+		{
+			if ((*itr)->Find(id, parameters))
+				return true;
+		}
+	}
+
+	auto itr = mBuiltins.find(id);
+	if (itr == mBuiltins.end())
+		return false;
+
+	parameters = To_Parameters(*itr);
+	return true;
+}
+
+bool CPatient_Registry::Find(uint32_t config_class, uint32_t config_id, TPatient_Parameters& parameters) const
+{
+	{
+		std::lock_guard<std::mutex> lck(mMtx);
+		for (auto itr = mDatabases.rbegin(); itr != mDatabases.rend(); ++itr)
+		{
+			if ((*itr)->Find(config_class, config_id, parameters))
+				return true;
+		}
+	}
+
+	// there are just a few built-in patients
+	for (const auto& builtin : mBuiltins)
+	{
+		// a database may override the built-in patient by its GUID
+		if (builtin.second.config_class == config_class && builtin.second.config_id == config_id)
+			return Find(builtin.first, parameters);
+	}
+
+	return false;
+}
+
+std::string CPatient_Registry::Get_Parameters_String(const GUID& id) const
+{
+	TPatient_Parameters parameters;
+	if (!Find(id, parameters))
+		return "";
+
+	// built-in patients keep their original text, so the configuration is exactly the same as before
+	auto itr = mBuiltins.find(id);
+	if (itr != mBuiltins.end() && parameters.values == itr->second.values.data())
+		return itr->second.text;
+
+	std::ostringstream oss;
+	oss.imbue(std::locale::classic());
+	oss << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+	for (size_t i = 0; i < parameters.value_count; i++)
+	{
+		if (i > 0)
+			oss << ' ';
+		oss << parameters.values[i];
+	}
+
+	return oss.str();
+}
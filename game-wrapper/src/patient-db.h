@@ -0,0 +1,194 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#pragma once
+
+#include <scgms/rtl/guid.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Binary virtual patient database
+ * The file consists of a header, a table of fixed-size entries sorted by patient GUID and a block of model parameters stored as doubles (lower|default|upper bounds)
+ * The file is memory-mapped, so the parameters of a patient are accessed in place, without any parsing
+ */
+
+// patient databases are expected to use this extension
+constexpr const char* Patient_Database_Extension = ".spdb";
+
+constexpr const char Patient_Database_Magic[8] = { 'S', 'C', 'G', 'M', 'S', 'P', 'D', '\0' };
+constexpr const uint32_t Patient_Database_Version = 1;
+
+// maximum length of patient name including the terminating zero
+constexpr const size_t Patient_Name_Size = 32;
+
+struct TPatient_Database_Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t entry_size;
+	uint64_t entry_count;
+	uint64_t reserved;
+};
+
+struct TPatient_Database_Entry
+{
+	GUID id;
+	// config class and config ID, under which the patient is selected in scgms_game_create
+	uint32_t config_class;
+	uint32_t config_id;
+	// file offset of the parameters
+	uint64_t values_offset;
+	uint32_t value_count;
+	uint32_t reserved;
+	char name[Patient_Name_Size];
+};
+
+static_assert(sizeof(TPatient_Database_Header) == 32, "Patient database header must be 32 bytes long");
+static_assert(sizeof(TPatient_Database_Entry) == 72, "Patient database entry must be 72 bytes long");
+
+// built-in patients, always available
+namespace patients
+{
+	extern const GUID patient_s2013_1;
+	extern const GUID patient_gct_1;
+}
+
+// view of parameters of a single patient; valid for the whole lifetime of the process
+struct TPatient_Parameters
+{
+	const GUID* id = nullptr;
+	uint32_t config_class = 0;
+	uint32_t config_id = 0;
+	const double* values = nullptr;
+	size_t value_count = 0;
+};
+
+// a patient to be stored by Write_Patient_Database
+struct TPatient_Record
+{
+	GUID id;
+	uint32_t config_class;
+	uint32_t config_id;
+	std::string name;
+	std::vector<double> values;
+};
+
+/*
+ * Memory-mapped patient database file
+ */
+class CPatient_Database
+{
+	private:
+		const TPatient_Database_Entry* mEntries = nullptr;
+		size_t mEntry_Count = 0;
+		// (config class << 32 | config id) -> entry index
+		std::map<uint64_t, size_t> mSelectors;
+
+		void* mMapping = nullptr;
+		size_t mMapping_Size = 0;
+#ifdef _WIN32
+		void* mFile_Handle = nullptr;
+		void* mMapping_Handle = nullptr;
+#endif
+
+		TPatient_Parameters To_Parameters(const TPatient_Database_Entry& entry) const;
+
+	public:
+		CPatient_Database() = default;
+		CPatient_Database(const CPatient_Database&) = delete;
+		CPatient_Database& operator=(const CPatient_Database&) = delete;
+		virtual ~CPatient_Database();
+
+		// maps the database file to memory and validates its contents
+		bool Open(const std::string& path);
+		void Close();
+
+		size_t Size() const
+		{
+			return mEntry_Count;
+		}
+
+		// binary search over the entry table
+		bool Find(const GUID& id, TPatient_Parameters& parameters) const;
+		bool Find(uint32_t config_class, uint32_t config_id, TPatient_Parameters& parameters) const;
+};
+
+// writes given patients to a new database file; patients are sorted by GUID, duplicate GUIDs are rejected
+bool Write_Patient_Database(const std::string& path, std::vector<TPatient_Record> patients);
+
+/*
+ * Process-wide registry of patients; built-in patients are always present, loaded databases take precedence over them
+ * Databases are never unloaded, so the retrieved parameter views stay valid
+ */
+class CPatient_Registry
+{
+	private:
+		mutable std::mutex mMtx;
+		// searched from the most recently loaded one
+		std::vector<std::unique_ptr<CPatient_Database>> mDatabases;
+
+		// built-in patients, parsed once from their text form
+		struct TBuiltin_Patient
+		{
+			uint32_t config_class;
+			uint32_t config_id;
+			std::string text;
+			std::vector<double> values;
+		};
+		std::map<GUID, TBuiltin_Patient> mBuiltins;
+
+		TPatient_Parameters To_Parameters(const std::map<GUID, TBuiltin_Patient>::value_type& builtin) const;
+
+		CPatient_Registry();
+
+	public:
+		static CPatient_Registry& Instance();
+
+		bool Load_Database(const std::string& path);
+
+		bool Find(const GUID& id, TPatient_Parameters& parameters) const;
+		bool Find(uint32_t config_class, uint32_t config_id, TPatient_Parameters& parameters) const;
+
+		// retrieves the patient parameters in the textual form used by filter configurations; empty string if there is no such patient
+		std::string Get_Parameters_String(const GUID& id) const;
+};
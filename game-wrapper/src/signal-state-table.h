@@ -0,0 +1,169 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/guid.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+/*
+ * Flat table of last known signal levels; maps signal GUIDs to dense slots using an open-addressing hash index
+ * Slots are assigned in the order of registration and remain stable until the table is cleared
+ */
+class CSignal_State_Table
+{
+	public:
+		static constexpr size_t Invalid_Slot = std::numeric_limits<size_t>::max();
+
+	private:
+		// open-addressing index; stores slot + 1, zero marks an empty bucket; size is always a power of two
+		std::vector<uint32_t> mIndex;
+		// registered signal IDs, indexed by slot
+		std::vector<GUID> mIds;
+		// last known levels, indexed by slot
+		std::vector<double> mLevels;
+
+		static size_t Hash(const GUID& id)
+		{
+			uint64_t lo, hi;
+			std::memcpy(&lo, &id, sizeof(lo));
+			std::memcpy(&hi, reinterpret_cast<const uint8_t*>(&id) + sizeof(lo), sizeof(hi));
+
+			uint64_t h = lo ^ (hi * 0x9E3779B97F4A7C15ULL);
+			h ^= h >> 32;
+			return static_cast<size_t>(h);
+		}
+
+		void Rehash(size_t bucket_count)
+		{
+			mIndex.assign(bucket_count, 0);
+			const size_t mask = bucket_count - 1;
+
+			for (size_t slot = 0; slot < mIds.size(); slot++)
+			{
+				size_t bucket = Hash(mIds[slot]) & mask;
+				while (mIndex[bucket] != 0)
+					bucket = (bucket + 1) & mask;
+
+				mIndex[bucket] = static_cast<uint32_t>(slot + 1);
+			}
+		}
+
+	public:
+		CSignal_State_Table(size_t expected_signals = 64)
+		{
+			size_t buckets = 16;
+			while (buckets < expected_signals * 2)
+				buckets <<= 1;
+
+			mIndex.assign(buckets, 0);
+			mIds.reserve(expected_signals);
+			mLevels.reserve(expected_signals);
+		}
+
+		// drops all registered signals, keeps allocated memory
+		void Clear()
+		{
+			std::fill(mIndex.begin(), mIndex.end(), 0);
+			mIds.clear();
+			mLevels.clear();
+		}
+
+		// retrieves slot of given signal, or Invalid_Slot if the signal was never registered
+		size_t Find(const GUID& id) const
+		{
+			const size_t mask = mIndex.size() - 1;
+			size_t bucket = Hash(id) & mask;
+
+			while (mIndex[bucket] != 0)
+			{
+				const size_t slot = mIndex[bucket] - 1;
+				if (mIds[slot] == id)
+					return slot;
+
+				bucket = (bucket + 1) & mask;
+			}
+
+			return Invalid_Slot;
+		}
+
+		// retrieves slot of given signal, registers the signal if not yet present
+		size_t Find_Or_Add(const GUID& id)
+		{
+			const size_t existing = Find(id);
+			if (existing != Invalid_Slot)
+				return existing;
+
+			const size_t slot = mIds.size();
+			mIds.push_back(id);
+			mLevels.push_back(std::numeric_limits<double>::quiet_NaN());
+
+			// keep load factor under 1/2, so the probe sequences stay short
+			if (mIds.size() * 2 > mIndex.size())
+				Rehash(mIndex.size() * 2);
+			else
+			{
+				const size_t mask = mIndex.size() - 1;
+				size_t bucket = Hash(id) & mask;
+				while (mIndex[bucket] != 0)
+					bucket = (bucket + 1) & mask;
+
+				mIndex[bucket] = static_cast<uint32_t>(slot + 1);
+			}
+
+			return slot;
+		}
+
+		void Set_Level(size_t slot, double level)
+		{
+			mLevels[slot] = level;
+		}
+
+		double Get_Level(size_t slot) const
+		{
+			return mLevels[slot];
+		}
+
+		size_t Size() const
+		{
+			return mIds.size();
+		}
+};
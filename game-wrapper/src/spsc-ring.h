@@ -0,0 +1,209 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/*
+ * Bounded single-producer/single-consumer ring buffer
+ * Push and Pop are lock-free as long as the ring is neither full nor empty; only then the calling side blocks
+ * Closing the ring releases both sides - the producer stops accepting items, the consumer drains what is left
+ */
+template <typename T>
+class CSPSC_Ring
+{
+	private:
+		static constexpr size_t Cache_Line_Size = 64;
+
+		std::vector<T> mBuffer;
+		size_t mMask;
+
+		// next position to be read; written by consumer only
+		alignas(Cache_Line_Size) std::atomic<size_t> mHead{ 0 };
+		// next position to be written; written by producer only
+		alignas(Cache_Line_Size) std::atomic<size_t> mTail{ 0 };
+
+		// count of sides blocked in Wait_For; lets the other side skip the mutex in the common case
+		alignas(Cache_Line_Size) std::atomic<size_t> mWaiters{ 0 };
+		std::atomic<bool> mClosed{ false };
+
+		std::mutex mWait_Mtx;
+		std::condition_variable mWait_Cv;
+
+		void Wake_Waiters()
+		{
+			// pairs with the fence in Wait_For; either we see the waiter, or the waiter sees our index update
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (mWaiters.load(std::memory_order_relaxed) > 0)
+			{
+				std::lock_guard<std::mutex> lck(mWait_Mtx);
+				mWait_Cv.notify_all();
+			}
+		}
+
+		template <typename TPredicate>
+		void Wait_For(TPredicate&& pred)
+		{
+			std::unique_lock<std::mutex> lck(mWait_Mtx);
+
+			mWaiters.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			mWait_Cv.wait(lck, [this, &pred]() { return pred() || mClosed.load(std::memory_order_acquire); });
+
+			mWaiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+	public:
+		explicit CSPSC_Ring(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+
+			mBuffer.resize(size);
+			mMask = size - 1;
+		}
+
+		size_t Capacity() const
+		{
+			return mBuffer.size();
+		}
+
+		// stores the item; blocks while the ring is full; returns false if the ring has been closed
+		bool Push(const T& item)
+		{
+			const size_t tail = mTail.load(std::memory_order_relaxed);
+
+			if (tail - mHead.load(std::memory_order_acquire) == mBuffer.size())
+				Wait_For([this, tail]() { return tail - mHead.load(std::memory_order_acquire) < mBuffer.size(); });
+
+			if (mClosed.load(std::memory_order_acquire))
+				return false;
+
+			mBuffer[tail & mMask] = item;
+			mTail.store(tail + 1, std::memory_order_release);
+
+			Wake_Waiters();
+
+			return true;
+		}
+
+		// retrieves the oldest item; blocks while the ring is empty; returns false if the ring is empty and closed
+		bool Pop(T& item)
+		{
+			const size_t head = mHead.load(std::memory_order_relaxed);
+
+			if (mTail.load(std::memory_order_acquire) == head)
+			{
+				Wait_For([this, head]() { return mTail.load(std::memory_order_acquire) != head; });
+
+				if (mTail.load(std::memory_order_acquire) == head)
+					return false;
+			}
+
+			item = mBuffer[head & mMask];
+			mHead.store(head + 1, std::memory_order_release);
+
+			Wake_Waiters();
+
+			return true;
+		}
+
+		// passes up to max_count oldest items to given consumer (called as consumer(item, index)); blocks until at least one item is available
+		// returns count of consumed items; zero means the ring is empty and closed
+		template <typename TConsumer>
+		size_t Pop_Bulk(size_t max_count, TConsumer&& consumer)
+		{
+			const size_t head = mHead.load(std::memory_order_relaxed);
+			size_t tail = mTail.load(std::memory_order_acquire);
+
+			if (tail == head)
+			{
+				Wait_For([this, head]() { return mTail.load(std::memory_order_acquire) != head; });
+
+				tail = mTail.load(std::memory_order_acquire);
+				if (tail == head)
+					return 0;
+			}
+
+			const size_t count = std::min(max_count, tail - head);
+			for (size_t i = 0; i < count; i++)
+				consumer(mBuffer[(head + i) & mMask], i);
+
+			mHead.store(head + count, std::memory_order_release);
+
+			Wake_Waiters();
+
+			return count;
+		}
+
+		// closes the ring; wakes up both sides
+		void Close()
+		{
+			{
+				std::lock_guard<std::mutex> lck(mWait_Mtx);
+				mClosed.store(true, std::memory_order_release);
+			}
+
+			mWait_Cv.notify_all();
+		}
+
+		// drops all items and reopens the ring; neither side may be using the ring meanwhile
+		void Reset()
+		{
+			mHead.store(0, std::memory_order_relaxed);
+			mTail.store(0, std::memory_order_relaxed);
+			mClosed.store(false, std::memory_order_release);
+		}
+
+		bool Is_Empty() const
+		{
+			return mTail.load(std::memory_order_acquire) == mHead.load(std::memory_order_acquire);
+		}
+
+		bool Is_Closed() const
+		{
+			return mClosed.load(std::memory_order_acquire);
+		}
+};
@@ -0,0 +1,138 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+
+#include "../src/patient-db.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Generator of binary virtual patient databases (.spdb) for scgms_game_load_patient_database
+ * The input is a text file with one patient per line; empty lines and lines starting with ';' are ignored:
+ *		{patient GUID} <config class> <config ID> <name> <parameter values...>
+ * Parameter values are the lower bounds, default values and upper bounds of the model parameters, in the same order as in filter configurations
+ * Usage: game-wrapper-patient-db-tool <input text file> <output database file>
+ */
+
+namespace
+{
+	// parses the input file; reports the first invalid line and returns false, if there is one
+	bool Read_Patients(const std::string& path, std::vector<TPatient_Record>& patients)
+	{
+		std::ifstream file(path);
+		if (!file.is_open())
+		{
+			std::cerr << "Could not open " << path << std::endl;
+			return false;
+		}
+
+		std::string line;
+		for (size_t line_number = 1; std::getline(file, line); line_number++)
+		{
+			std::istringstream iss(line);
+			iss.imbue(std::locale::classic());
+
+			std::string id_str;
+			if (!(iss >> id_str) || id_str[0] == ';')
+				continue;
+
+			TPatient_Record patient;
+
+			bool ok = false;
+			patient.id = WString_To_GUID(Widen_String(id_str), ok);
+
+			if (!ok || !(iss >> patient.config_class >> patient.config_id >> patient.name) || patient.name.length() >= Patient_Name_Size)
+			{
+				std::cerr << path << ":" << line_number << ": invalid patient declaration" << std::endl;
+				return false;
+			}
+
+			double value;
+			while (iss >> value)
+				patient.values.push_back(value);
+
+			// the values are triplets of bounds and defaults; anything left unread is not a number
+			if (!iss.eof() || patient.values.empty() || patient.values.size() % 3 != 0)
+			{
+				std::cerr << path << ":" << line_number << ": invalid parameter values" << std::endl;
+				return false;
+			}
+
+			patients.push_back(std::move(patient));
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: game-wrapper-patient-db-tool <input text file> <output database file>" << std::endl;
+		return 1;
+	}
+
+	std::vector<TPatient_Record> patients;
+	if (!Read_Patients(argv[1], patients))
+		return 2;
+
+	const size_t patient_count = patients.size();
+	if (!Write_Patient_Database(argv[2], std::move(patients)))
+	{
+		std::cerr << "Could not write " << argv[2] << " (duplicate patient GUIDs?)" << std::endl;
+		return 3;
+	}
+
+	// read the result back the same way the game wrapper does
+	CPatient_Database database;
+	if (!database.Open(argv[2]) || database.Size() != patient_count)
+	{
+		std::cerr << "The written database could not be validated" << std::endl;
+		return 3;
+	}
+
+	std::cout << "Written " << patient_count << " patients to " << argv[2] << std::endl;
+
+	return 0;
+}